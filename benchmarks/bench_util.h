@@ -0,0 +1,37 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace bench
+{
+   // seconds per call of f, best of `repeat` runs
+   template <class F>
+   double measure(F f, int repeat = 5)
+   {
+      double best = 1e100;
+      for (int r = 0; r != repeat; ++r)
+      {
+         auto start = std::chrono::steady_clock::now();
+         f();
+         std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+         best = std::min(best, d.count());
+      }
+      return best;
+   }
+
+   inline void report(char const * name, double seconds, size_t items)
+   {
+      std::printf("%-40s %10.3f ms %10.2f ns/item\n", name, seconds * 1e3, seconds * 1e9 / items);
+   }
+
+   // keeps the optimizer from dropping a computed value
+   template <class T>
+   void consume(T const & value)
+   {
+      static char volatile sink;
+      sink = *reinterpret_cast<char const volatile *>(&value);
+      (void)sink;
+   }
+}
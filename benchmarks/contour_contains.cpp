@@ -0,0 +1,89 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include <cg/operations/contains/contour_index.h>
+#include <cg/operations/contains/contour_edges.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// contains against one large star shaped contour (a geofence) by the edge loop, by contour_edges
+// one query at a time and in batches, and by contour_index.
+
+static contour_2 geofence(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> noise(-1, 1);
+   std::vector<point_2> pts;
+   double radius = 100;
+   for (size_t l = 0; l != n; ++l)
+   {
+      radius = std::max(50., std::min(150., radius + noise(gen)));
+      double t = 2 * M_PI * l / n;
+      pts.push_back(point_2(radius * cos(t), radius * sin(t)));
+   }
+   return contour_2(pts);
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<double> coord(-160, 160);
+   std::vector<point_2> points;
+   for (size_t l = 0; l != 1000000; ++l)
+      points.push_back(point_2(coord(gen), coord(gen)));
+
+   for (size_t n : {1000, 100000})
+   {
+      contour_2 c = geofence(gen, n);
+      std::printf("%zu vertices\n", n);
+
+      size_t slow = std::min<size_t>(points.size(), 100000000 / n);
+      double loop = bench::measure([&]()
+      {
+         size_t inside = 0;
+         for (size_t l = 0; l != slow; ++l)
+            inside += contains(c, points[l]);
+         bench::consume(inside);
+      }, 3);
+      bench::report("  contains", loop, slow);
+
+      contour_edges edges(c);
+      double single = bench::measure([&]()
+      {
+         size_t inside = 0;
+         for (size_t l = 0; l != slow; ++l)
+            inside += edges.contains(points[l]);
+         bench::consume(inside);
+      }, 3);
+      bench::report("  contour_edges contains", single, slow);
+
+      std::unique_ptr<bool[]> out(new bool[slow]);
+      double batch = bench::measure([&]()
+      {
+         edges.contains(points.data(), slow, out.get());
+         bench::consume(out[slow - 1]);
+      }, 3);
+      bench::report("  contour_edges batch", batch, slow);
+
+      double build = bench::measure([&]()
+      {
+         contour_index index(c);
+         bench::consume(index);
+      }, 3);
+      bench::report("  contour_index build, per vertex", build, n);
+
+      contour_index index(c);
+      double query = bench::measure([&]()
+      {
+         size_t inside = 0;
+         for (point_2 const & p : points)
+            inside += index.contains(p);
+         bench::consume(inside);
+      }, 3);
+      bench::report("  contour_index contains", query, points.size());
+   }
+}
@@ -0,0 +1,59 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include <cg/operations/contains/prepared_convex_polygon.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// contains against one convex polygon by convex_contains and by prepared_convex_polygon,
+// one query at a time and in batches.
+
+int main()
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<double> coord(-110, 110);
+   std::vector<point_2> points;
+   for (size_t l = 0; l != 1000000; ++l)
+      points.push_back(point_2(coord(gen), coord(gen)));
+
+   for (size_t n : {16, 1000, 100000, 1000000})
+   {
+      std::vector<point_2> pts;
+      for (size_t l = 0; l != n; ++l)
+         pts.push_back(point_2(100 * cos(2 * M_PI * l / n), 100 * sin(2 * M_PI * l / n)));
+      contour_2 c(pts);
+      std::printf("%zu vertices\n", n);
+
+      double loop = bench::measure([&]()
+      {
+         size_t inside = 0;
+         for (point_2 const & p : points)
+            inside += convex_contains(c, p);
+         bench::consume(inside);
+      }, 3);
+      bench::report("  convex_contains", loop, points.size());
+
+      prepared_convex_polygon prepared(c);
+      double single = bench::measure([&]()
+      {
+         size_t inside = 0;
+         for (point_2 const & p : points)
+            inside += prepared.contains(p);
+         bench::consume(inside);
+      }, 3);
+      bench::report("  prepared contains", single, points.size());
+
+      std::unique_ptr<bool[]> out(new bool[points.size()]);
+      double batch = bench::measure([&]()
+      {
+         prepared.contains(points.data(), points.size(), out.get());
+         bench::consume(out[points.size() - 1]);
+      }, 3);
+      bench::report("  prepared batch", batch, points.size());
+   }
+}
@@ -0,0 +1,113 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#include <cg/operations/convex_intersection.h>
+#include <cg/operations/minkowski_sum.h>
+#include <cg/intersections/polygon_boolean.h>
+#include <cg/convex_hull/graham.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// intersections and Minkowski sums of pairs of convex polygons of a few sizes: into one reused buffer,
+// into a new contour per pair, and against the general sweep and the hull of all the vertex sums
+
+// n vertices on a randomly squeezed ellipse, ccw
+static contour_2 ellipse(std::mt19937 & gen, size_t n, point_2 const & centre)
+{
+   std::uniform_real_distribution<double> axis(0.5, 1.5), phase(0, 2 * M_PI);
+   double rx = axis(gen), ry = axis(gen), t0 = phase(gen);
+   std::vector<point_2> pts;
+   for (size_t l = 0; l != n; ++l)
+   {
+      double t = t0 + 2 * M_PI * l / n;
+      pts.push_back(point_2(centre.x + rx * cos(t), centre.y + ry * sin(t)));
+   }
+   return contour_2(pts);
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<double> shift(-1, 1);
+   for (size_t n : {4, 8, 32, 1000})
+   {
+      size_t pairs = std::max<size_t>(100, 200000 / n);
+      std::vector<contour_2> polygons;
+      for (size_t l = 0; l != 2 * pairs; ++l)
+         polygons.push_back(ellipse(gen, n, point_2(shift(gen), shift(gen))));
+      std::printf("%zu pairs of convex polygons of %zu vertices\n", pairs, n);
+
+      std::vector<point_2> buffer(2 * n);
+      double t = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (size_t l = 0; l != pairs; ++l)
+            count += convex_intersection(polygons[2 * l], polygons[2 * l + 1], buffer.data()) - buffer.data();
+         bench::consume(count);
+      }, 3);
+      bench::report("  convex_intersection, buffer", t, pairs);
+
+      t = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (size_t l = 0; l != pairs; ++l)
+            count += convex_intersection(polygons[2 * l], polygons[2 * l + 1]).size();
+         bench::consume(count);
+      }, 3);
+      bench::report("  convex_intersection, contour", t, pairs);
+
+      if (n <= 32)
+      {
+         t = bench::measure([&]()
+         {
+            size_t count = 0;
+            for (size_t l = 0; l != pairs; ++l)
+               count += detail::sweep_boolean(std::vector<contour_2>(1, polygons[2 * l]), std::vector<contour_2>(1, polygons[2 * l + 1]),
+                                              CG_INTERSECTION).size();
+            bench::consume(count);
+         }, 1);
+         bench::report("  intersection by the sweep", t, pairs);
+      }
+
+      t = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (size_t l = 0; l != pairs; ++l)
+            count += minkowski_sum(polygons[2 * l], polygons[2 * l + 1], buffer.data()) - buffer.data();
+         bench::consume(count);
+      }, 3);
+      bench::report("  minkowski_sum, buffer", t, pairs);
+
+      t = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (size_t l = 0; l != pairs; ++l)
+            count += minkowski_sum(polygons[2 * l], polygons[2 * l + 1]).size();
+         bench::consume(count);
+      }, 3);
+      bench::report("  minkowski_sum, contour", t, pairs);
+
+      if (n <= 32)
+      {
+         std::vector<point_2> sums;
+         t = bench::measure([&]()
+         {
+            size_t count = 0;
+            for (size_t l = 0; l != pairs; ++l)
+            {
+               sums.clear();
+               for (point_2 const & p : polygons[2 * l])
+                  for (point_2 const & q : polygons[2 * l + 1])
+                     sums.push_back(point_2(p.x + q.x, p.y + q.y));
+               count += graham_hull(sums.begin(), sums.end()) - sums.begin();
+            }
+            bench::consume(count);
+         }, 1);
+         bench::report("  hull of all the vertex sums", t, pairs);
+      }
+   }
+}
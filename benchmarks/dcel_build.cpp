@@ -0,0 +1,63 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/dcel/dcel.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// Arrangement of n random lines built by repeated add_line and by DCEL::build.
+
+static std::vector<line> random_lines(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> coord(-100, 100);
+   std::vector<line> lines;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen)), b(coord(gen), coord(gen));
+      line res(b.y - a.y, a.x - b.x, 0);
+      res.c = -(res.a * a.x + res.b * a.y);
+      if (!is_direct_vector_right(res))
+         res.inverse_vector();
+      lines.push_back(res);
+   }
+   return lines;
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   for (size_t n : {100, 300, 1000})
+   {
+      std::vector<line> lines = random_lines(gen, n);
+      std::printf("%zu lines, %zu vertices\n", n, n * (n - 1) / 2);
+      size_t items = n * (n - 1) / 2;
+
+      double incremental = bench::measure([&]()
+      {
+         DCEL dcel(lines[0], lines[1]);
+         for (size_t l = 2; l != n; ++l)
+            dcel.add_line(lines[l]);
+         bench::consume(dcel.faces.size());
+      }, 3);
+      bench::report("  add_line", incremental, items);
+
+      double single = bench::measure([&]()
+      {
+         DCEL dcel;
+         dcel.build(lines, 1);
+         bench::consume(dcel.faces.size());
+      }, 3);
+      bench::report("  build, 1 thread", single, items);
+
+      double parallel = bench::measure([&]()
+      {
+         DCEL dcel;
+         dcel.build(lines);
+         bench::consume(dcel.faces.size());
+      }, 3);
+      bench::report("  build", parallel, items);
+   }
+}
@@ -0,0 +1,99 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/operations/has_intersection/segment_segment.h>
+#include <cg/operations/has_intersection/triangle_segment.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// has_intersection for segment/segment and triangle/segment pairs, against the tests without bounding
+// boxes and shared orientations, on sparse pairs (mostly far apart) and dense ones (mostly overlapping boxes)
+
+static bool unfiltered(segment_2 const & a, segment_2 const & b)
+{
+   if (a[0] == a[1])
+      return contains(b, a[0]);
+
+   orientation_t ab[2];
+   for (size_t l = 0; l != 2; ++l)
+      ab[l] = orientation(a[0], a[1], b[l]);
+
+   if (ab[0] == ab[1] && ab[0] == CG_COLLINEAR)
+      return collinear_overlap(a, b);
+
+   if (ab[0] == ab[1])
+      return false;
+
+   for (size_t l = 0; l != 2; ++l)
+      ab[l] = orientation(b[0], b[1], a[l]);
+
+   return ab[0] != ab[1];
+}
+
+static bool unfiltered(triangle_2 const & t, segment_2 const & s)
+{
+   if (contains(t, s[0]))
+      return true;
+
+   for (size_t l = 0; l != 3; ++l)
+      if (unfiltered(t.side(l), s))
+         return true;
+
+   return false;
+}
+
+static void run(char const * name, double range, size_t n)
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<double> coord(0, range), delta(-1, 1);
+   auto near = [&](point_2 const & a) { return point_2(a.x + delta(gen), a.y + delta(gen)); };
+
+   std::vector<segment_2> a, b;
+   std::vector<triangle_2> t;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 p(coord(gen), coord(gen)), q(coord(gen), coord(gen));
+      a.push_back(segment_2(p, near(p)));
+      b.push_back(segment_2(q, near(q)));
+      t.push_back(triangle_2(p, near(p), near(p)));
+   }
+
+   std::printf("%s pairs\n", name);
+   size_t hits = 0;
+   auto time = [&](char const * what, bool (*f)(segment_2 const &, segment_2 const &))
+   {
+      bench::report(what, bench::measure([&]()
+      {
+         hits = 0;
+         for (size_t l = 0; l != n; ++l)
+            hits += f(a[l], b[l]);
+         bench::consume(hits);
+      }), n);
+   };
+   auto time_t = [&](char const * what, bool (*f)(triangle_2 const &, segment_2 const &))
+   {
+      bench::report(what, bench::measure([&]()
+      {
+         hits = 0;
+         for (size_t l = 0; l != n; ++l)
+            hits += f(t[l], b[l]);
+         bench::consume(hits);
+      }), n);
+   };
+
+   time("  segment/segment, unfiltered", &unfiltered);
+   time("  segment/segment", &has_intersection<double>);
+   std::printf("  %.1f%% intersect\n", 100. * hits / n);
+   time_t("  triangle/segment, unfiltered", &unfiltered);
+   time_t("  triangle/segment", &has_intersection<double>);
+   std::printf("  %.1f%% intersect\n", 100. * hits / n);
+}
+
+int main()
+{
+   run("sparse", 1000, 1000000);
+   run("dense", 1.5, 1000000);
+}
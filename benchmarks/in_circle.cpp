@@ -0,0 +1,96 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#include <cg/operations/in_circle.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// Which stage of the in_circle filter chain decides the queries of one input family,
+// and the cost of the scalar and the batched predicate on it.
+
+struct query
+{
+   point_2 a, b, c;
+   std::vector<point_2> d;
+};
+
+static query random_box(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> coord(-1, 1);
+   query q;
+   q.a = point_2(coord(gen), coord(gen));
+   q.b = point_2(coord(gen), coord(gen));
+   q.c = point_2(coord(gen), coord(gen));
+   for (size_t l = 0; l != n; ++l)
+      q.d.push_back(point_2(coord(gen), coord(gen)));
+   return q;
+}
+
+// points rounded from a circle far from the origin, the typical degenerate case of mesh generators
+static query near_circle(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> angle(0, 2 * M_PI);
+   auto on_circle = [&]() { double t = angle(gen); return point_2(1e4 + cos(t), 1e4 + sin(t)); };
+   query q;
+   q.a = on_circle();
+   q.b = on_circle();
+   q.c = on_circle();
+   for (size_t l = 0; l != n; ++l)
+      q.d.push_back(on_circle());
+   return q;
+}
+
+// integer grid, many exactly cocircular quadruples
+static query grid(std::mt19937 & gen, size_t n)
+{
+   std::uniform_int_distribution<int> coord(-8, 8);
+   query q;
+   q.a = point_2(-5, 0);
+   q.b = point_2(5, 0);
+   q.c = point_2(0, 5);
+   for (size_t l = 0; l != n; ++l)
+      q.d.push_back(point_2(coord(gen), coord(gen)));
+   return q;
+}
+
+static void run(char const * name, query const & q)
+{
+   size_t n = q.d.size(), by_d = 0, by_i = 0;
+   for (point_2 const & d : q.d)
+   {
+      if (in_circle_d()(q.a, q.b, q.c, d))
+         ++by_d;
+      else if (in_circle_i()(q.a, q.b, q.c, d))
+         ++by_i;
+   }
+   std::printf("%s: double filter %.2f%%, interval %.2f%%, exact %.2f%%\n", name,
+               100. * by_d / n, 100. * by_i / n, 100. * (n - by_d - by_i) / n);
+
+   std::vector<in_circle_t> out(n);
+   double scalar = bench::measure([&]()
+   {
+      for (size_t l = 0; l != n; ++l)
+         out[l] = in_circle(q.a, q.b, q.c, q.d[l]);
+      bench::consume(out.back());
+   });
+   bench::report("  scalar", scalar, n);
+
+   double batch = bench::measure([&]()
+   {
+      in_circle(q.a, q.b, q.c, q.d, out);
+      bench::consume(out.back());
+   });
+   bench::report("  batch", batch, n);
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   run("random box", random_box(gen, 1 << 20));
+   run("near circle", near_circle(gen, 1 << 16));
+   run("integer grid", grid(gen, 1 << 16));
+}
@@ -0,0 +1,81 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/dcel/kirkpatrick.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// Point location in the Kirkpatrick hierarchy of n random lines:
+// the leaf edge by fast_localization, the face by locate one point at a time and by locate_batch
+// on one thread and on all cores.
+
+static std::vector<line> random_lines(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> coord(-100, 100);
+   std::vector<line> lines;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen)), b(coord(gen), coord(gen));
+      line res(b.y - a.y, a.x - b.x, 0);
+      res.c = -(res.a * a.x + res.b * a.y);
+      if (!is_direct_vector_right(res))
+         res.inverse_vector();
+      lines.push_back(res);
+   }
+   return lines;
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<double> coord(-100, 100);
+   size_t const queries = 1000000;
+   std::vector<point_2> points;
+   for (size_t l = 0; l != queries; ++l)
+      points.push_back(point_2(coord(gen), coord(gen)));
+
+   for (size_t n : {10, 20, 40})
+   {
+      std::vector<line> lines = random_lines(gen, n);
+      kirkpatrick_localization kl(lines[0], lines[1]);
+      for (size_t l = 2; l != n; ++l)
+         kl.add_line(lines[l]);
+      std::vector<std::vector<uint32_t>> deleted_vertices;
+      kl.build_triangulation(deleted_vertices);
+      std::printf("%zu lines, %zu nodes, %zu queries\n", n, kl.nodes.size(), queries);
+
+      std::vector<uint32_t> edges(queries), faces(queries);
+      double leaf = bench::measure([&]()
+      {
+         for (size_t l = 0; l != queries; ++l)
+            edges[l] = kl.fast_localization(points[l]);
+         bench::consume(edges.back());
+      }, 3);
+      bench::report("  fast_localization", leaf, queries);
+
+      double single = bench::measure([&]()
+      {
+         for (size_t l = 0; l != queries; ++l)
+            faces[l] = kl.locate(points[l]);
+         bench::consume(faces.back());
+      }, 3);
+      bench::report("  locate", single, queries);
+
+      double batch = bench::measure([&]()
+      {
+         kl.locate_batch(points, faces, 1);
+         bench::consume(faces.back());
+      }, 3);
+      bench::report("  locate_batch, 1 thread", batch, queries);
+
+      double parallel = bench::measure([&]()
+      {
+         kl.locate_batch(points, faces);
+         bench::consume(faces.back());
+      }, 3);
+      bench::report("  locate_batch", parallel, queries);
+   }
+}
@@ -0,0 +1,135 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/dcel/kirkpatrick.h>
+#include <cg/dcel/trapezoidal_map.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// Which stage of the line crossing predicates decides the calls made while building arrangements
+// of one input family, and the cost of a turn on cached crossings and on six lines.
+
+static line through(point_2 a, point_2 b)
+{
+   line res(b.y - a.y, a.x - b.x, 0);
+   res.c = -(res.a * a.x + res.b * a.y);
+   if (!is_direct_vector_right(res))
+      res.inverse_vector();
+   return res;
+}
+
+static std::vector<line> random_lines(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> coord(-100, 100);
+   std::vector<line> lines;
+   for (size_t l = 0; l != n; ++l)
+      lines.push_back(through(point_2(coord(gen), coord(gen)), point_2(coord(gen), coord(gen))));
+   return lines;
+}
+
+// lines through a few integer points, many crossings coincide
+static std::vector<line> concurrent_lines(std::mt19937 & gen, size_t n)
+{
+   std::uniform_int_distribution<int> coord(-3, 3), dir(-20, 20);
+   std::vector<line> lines;
+   while (lines.size() != n)
+   {
+      point_2 a(coord(gen), coord(gen)), d(dir(gen), dir(gen));
+      if (d.x == 0 || d.y == 0)
+         continue;
+      line l = through(a, point_2(a.x + d.x, a.y + d.y));
+      bool parallel = false;
+      for (line const & m : lines)
+         parallel |= orientation_2d(l.a, l.b, m.a, m.b) == ZERO_DEAD;
+      if (!parallel)
+         lines.push_back(l);
+   }
+   return lines;
+}
+
+// lines with slopes close to one, crossing at small angles
+static std::vector<line> nearly_parallel(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> coord(-100, 100), slope(1 - 1e-6, 1 + 1e-6);
+   std::vector<line> lines;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen));
+      lines.push_back(through(a, point_2(a.x + 1, a.y + slope(gen))));
+   }
+   return lines;
+}
+
+static void stages(char const * name)
+{
+   line_predicate_stats s = line_predicate_counters();
+   std::printf("  %-20s %10zu calls, interval %.3f%%, exact %.3f%%\n", name, s.calls,
+               100. * s.interval / std::max<size_t>(s.calls, 1), 100. * s.exact / std::max<size_t>(s.calls, 1));
+   line_predicate_counters() = line_predicate_stats{0, 0, 0};
+}
+
+// build_triangulation does not stop on coinciding crossings, so the hierarchy is built for lines in general position only
+static void run(char const * name, std::vector<line> const & lines, bool general_position)
+{
+   std::printf("%s, %zu lines\n", name, lines.size());
+   line_predicate_counters() = line_predicate_stats{0, 0, 0};
+
+   DCEL incremental(lines[0], lines[1]);
+   for (size_t l = 2; l != lines.size(); ++l)
+      incremental.add_line(lines[l]);
+   stages("add_line");
+
+   if (general_position)
+   {
+      kirkpatrick_locator kirkpatrick;
+      kirkpatrick.build(lines);
+      stages("kirkpatrick build");
+   }
+
+   trapezoidal_map trapezoids;
+   trapezoids.build(lines);
+   stages("trapezoidal map");
+
+   // turns of random vertex triples, from the cached crossings and from the lines
+   DCEL const & dcel = trapezoids.arrangement();
+   std::mt19937 gen(1);
+   std::uniform_int_distribution<uint32_t> pick(0, dcel.vertices.size() - 1);
+   std::vector<uint32_t> triples;
+   for (size_t l = 0; l != 3 << 18; ++l)
+      triples.push_back(pick(gen));
+   size_t n = triples.size() / 3;
+
+   int sum = 0;
+   double cached = bench::measure([&]()
+   {
+      for (size_t l = 0; l != triples.size(); l += 3)
+         sum += orientation(dcel.vertex_cross(triples[l]), dcel.vertex_cross(triples[l + 1]), dcel.vertex_cross(triples[l + 2]));
+      bench::consume(sum);
+   });
+   bench::report("  turn, cached crossings", cached, n);
+   line_predicate_counters() = line_predicate_stats{0, 0, 0};
+
+   double from_lines = bench::measure([&]()
+   {
+      for (size_t l = 0; l != triples.size(); l += 3)
+      {
+         vertex const & u = dcel.vertices[triples[l]], & v = dcel.vertices[triples[l + 1]], & w = dcel.vertices[triples[l + 2]];
+         sum += precise_turn_predicate(dcel.lines[u.line1], dcel.lines[u.line2], dcel.lines[v.line1], dcel.lines[v.line2],
+                                       dcel.lines[w.line1], dcel.lines[w.line2]);
+      }
+      bench::consume(sum);
+   });
+   bench::report("  turn, from lines", from_lines, n);
+   line_predicate_counters() = line_predicate_stats{0, 0, 0};
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   run("random lines", random_lines(gen, 40), true);
+   run("concurrent lines", concurrent_lines(gen, 40), false);
+   run("nearly parallel lines", nearly_parallel(gen, 40), true);
+}
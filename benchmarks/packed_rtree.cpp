@@ -0,0 +1,84 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/trees/packed_rtree.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// bulk load of a packed_rtree of short segments and rectangle and segment queries against it,
+// one at a time and in a batch, compared with testing every segment
+
+int main()
+{
+   std::mt19937 gen(0);
+   for (size_t n : {100000, 1000000, 10000000})
+   {
+      double length = 1000 / std::sqrt(double(n));
+      std::uniform_real_distribution<double> coord(0, 1000), delta(-length, length);
+      std::vector<segment_2> segments;
+      for (size_t l = 0; l != n; ++l)
+      {
+         point_2 a(coord(gen), coord(gen));
+         segments.push_back(segment_2(a, point_2(a.x + delta(gen), a.y + delta(gen))));
+      }
+      std::printf("%zu segments\n", n);
+
+      double build = bench::measure([&]()
+      {
+         packed_rtree<segment_2> tree(segments);
+         bench::consume(tree);
+      }, 1);
+      bench::report("  build, per segment", build, n);
+
+      packed_rtree<segment_2> tree(segments);
+      std::vector<rectangle_2> windows;
+      std::vector<segment_2> probes;
+      for (size_t l = 0; l != 100000; ++l)
+      {
+         point_2 a(coord(gen), coord(gen));
+         windows.push_back(rectangle_2(a, point_2(a.x + 10 * length, a.y + 10 * length)));
+         probes.push_back(segment_2(a, point_2(a.x + 10 * delta(gen), a.y + 10 * delta(gen))));
+      }
+
+      size_t found = 0;
+      double single = bench::measure([&]()
+      {
+         found = 0;
+         for (rectangle_2 const & w : windows)
+            tree.query(w, [&found](size_t) { ++found; });
+      }, 1);
+      bench::report("  rectangle query", single, windows.size());
+
+      std::vector<uint32_t> first, hits;
+      double batch = bench::measure([&]()
+      {
+         tree.query(windows, first, hits);
+         bench::consume(hits.size());
+      }, 1);
+      bench::report("  rectangle batch", batch, windows.size());
+
+      double segment_batch = bench::measure([&]()
+      {
+         tree.query(probes, first, hits);
+         bench::consume(hits.size());
+      }, 1);
+      bench::report("  segment batch", segment_batch, probes.size());
+      std::printf("  %.1f segments per rectangle\n", double(found) / windows.size());
+
+      if (n > 100000)
+         continue;
+
+      double scan = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (size_t l = 0; l != 100; ++l)
+            for (segment_2 const & s : segments)
+               count += has_intersection(windows[l], s);
+         bench::consume(count);
+      }, 1);
+      bench::report("  every segment, per rectangle", scan, 100);
+   }
+}
@@ -0,0 +1,72 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/dcel/kirkpatrick.h>
+#include <cg/dcel/trapezoidal_map.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// Kirkpatrick hierarchy and trapezoidal map behind point_locator on the same arrangements of n random lines:
+// build time and locate time for random points.
+
+static std::vector<line> random_lines(std::mt19937 & gen, size_t n)
+{
+   std::uniform_real_distribution<double> coord(-100, 100);
+   std::vector<line> lines;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen)), b(coord(gen), coord(gen));
+      line res(b.y - a.y, a.x - b.x, 0);
+      res.c = -(res.a * a.x + res.b * a.y);
+      if (!is_direct_vector_right(res))
+         res.inverse_vector();
+      lines.push_back(res);
+   }
+   return lines;
+}
+
+static void run(char const * name, point_locator & locator, std::vector<line> const & lines,
+                std::vector<point_2> const & points)
+{
+   char label[64];
+   double build = bench::measure([&]()
+   {
+      locator.build(lines);
+      bench::consume(locator.arrangement().faces.size());
+   }, 3);
+   std::snprintf(label, sizeof label, "  %s build", name);
+   bench::report(label, build, locator.arrangement().edges.size() / 2);
+
+   double query = bench::measure([&]()
+   {
+      uint32_t sum = 0;
+      for (point_2 const & p : points)
+         sum += locator.locate(p);
+      bench::consume(sum);
+   }, 3);
+   std::snprintf(label, sizeof label, "  %s locate", name);
+   bench::report(label, query, points.size());
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   std::uniform_real_distribution<double> coord(-100, 100);
+   std::vector<point_2> points;
+   for (size_t l = 0; l != 200000; ++l)
+      points.push_back(point_2(coord(gen), coord(gen)));
+
+   // build_triangulation takes seconds beyond a hundred lines
+   for (size_t n : {10, 20, 40, 80})
+   {
+      std::vector<line> lines = random_lines(gen, n);
+      std::printf("%zu lines, %zu queries, build per edge\n", n, points.size());
+      kirkpatrick_locator kirkpatrick;
+      run("kirkpatrick", kirkpatrick, lines, points);
+      trapezoidal_map trapezoids;
+      run("trapezoidal map", trapezoids, lines, points);
+   }
+}
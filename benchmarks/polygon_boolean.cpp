@@ -0,0 +1,108 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#include <cg/intersections/polygon_boolean.h>
+#include <cg/intersections/red_blue.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// boolean operations on two large star shaped polygons, intersections of small convex polygons by the
+// convex path and by the sweep, and many small polygons clipped against one window on one and on all threads
+
+// radius taking a random walk of steps up to noise times the radius
+static contour_2 star(std::mt19937 & gen, size_t n, point_2 const & centre, double radius, double noise)
+{
+   std::uniform_real_distribution<double> d(-noise, noise);
+   std::vector<point_2> pts;
+   double r = radius;
+   for (size_t l = 0; l != n; ++l)
+   {
+      double t = 2 * M_PI * l / n;
+      r = std::max(0.5 * radius, std::min(1.5 * radius, r + radius * d(gen)));
+      pts.push_back(point_2(centre.x + r * cos(t), centre.y + r * sin(t)));
+   }
+   return contour_2(pts);
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   for (size_t n : {1000, 100000})
+   {
+      std::vector<contour_2> a(1, star(gen, n, point_2(0, 0), 100, 0.01)), b(1, star(gen, n, point_2(50, 0), 100, 0.01));
+      size_t crossings = 0;
+      for_each_red_blue_intersection(layer_segments(a), layer_segments(b), [&crossings](size_t, size_t, point_2 const &) { ++crossings; });
+      std::printf("two stars of %zu vertices, %zu crossings\n", n, crossings);
+      for (boolean_operation_t op : {CG_UNION, CG_INTERSECTION, CG_DIFFERENCE})
+      {
+         size_t vertices = 0;
+         double t = bench::measure([&]()
+         {
+            vertices = 0;
+            for (contour_2 const & c : boolean_operation(a, b, op))
+               vertices += c.size();
+         }, 1);
+         char const * name[] = {"  union, per input vertex", "  intersection, per input vertex", "  difference, per input vertex"};
+         bench::report(name[op], t, 2 * n);
+      }
+   }
+
+   std::uniform_real_distribution<double> shift(-1, 1);
+   std::vector<std::vector<contour_2> > small;
+   for (size_t l = 0; l != 40000; ++l)
+      small.push_back(std::vector<contour_2>(1, star(gen, 8, point_2(shift(gen), shift(gen)), 1, 0)));
+
+   double fast = bench::measure([&]()
+   {
+      size_t count = 0;
+      for (size_t l = 0; l + 1 < small.size(); l += 2)
+         count += polygon_intersection(small[l], small[l + 1]).size();
+      bench::consume(count);
+   }, 3);
+   bench::report("convex octagons, convex_intersection", fast, small.size() / 2);
+
+   double sweep = bench::measure([&]()
+   {
+      size_t count = 0;
+      for (size_t l = 0; l + 1 < small.size(); l += 2)
+         count += detail::sweep_boolean(small[l], small[l + 1], CG_INTERSECTION).size();
+      bench::consume(count);
+   }, 3);
+   bench::report("convex octagons, sweep", sweep, small.size() / 2);
+
+   std::uniform_real_distribution<double> coord(-100, 100);
+   std::vector<std::vector<contour_2> > polygons;
+   for (size_t l = 0; l != 100000; ++l)
+      polygons.push_back(std::vector<contour_2>(1, star(gen, 12, point_2(coord(gen), coord(gen)), 3, 0.2)));
+   for (double noise : {0., 0.05})
+   {
+      std::vector<contour_2> window(1, star(gen, 64, point_2(0, 0), 60, noise));
+      std::printf("%zu polygons of 12 vertices against a %s window of 64 vertices\n", polygons.size(), noise == 0 ? "convex" : "star shaped");
+
+      double single = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (std::vector<contour_2> const & p : polygons)
+            count += detail::sweep_boolean(p, window, CG_INTERSECTION).size();
+         bench::consume(count);
+      }, 1);
+      bench::report("  sweep, per polygon", single, polygons.size());
+
+      std::vector<std::vector<contour_2> > out;
+      for (size_t threads : {size_t(1), common::hardware_threads()})
+      {
+         double t = bench::measure([&]()
+         {
+            clip(polygons, window, out, threads);
+            bench::consume(out.size());
+         }, 1);
+         char name[64];
+         std::snprintf(name, sizeof name, "  clip on %zu threads, per polygon", threads);
+         bench::report(name, t, polygons.size());
+      }
+   }
+}
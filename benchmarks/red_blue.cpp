@@ -0,0 +1,69 @@
+#include <vector>
+#include <cmath>
+#include <cstdio>
+
+#include <cg/intersections/red_blue.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// red blue intersections of two layers of square polygons (a grid and the grid turned by a small angle)
+// by the coloured sweep, by the sweep over all segments, and by testing every red blue pair
+
+static std::vector<contour_2> squares(int n, double angle)
+{
+   double c = cos(angle), s = sin(angle);
+   std::vector<contour_2> res;
+   for (int i = 0; i != n; ++i)
+      for (int j = 0; j != n; ++j)
+      {
+         std::vector<point_2> pts;
+         double corner[4][2] = {{0.1, 0.1}, {0.9, 0.1}, {0.9, 0.9}, {0.1, 0.9}};
+         for (auto const & d : corner)
+            pts.push_back(point_2(c * (i + d[0]) - s * (j + d[1]), s * (i + d[0]) + c * (j + d[1])));
+         res.push_back(contour_2(pts));
+      }
+   return res;
+}
+
+int main()
+{
+   for (int n : {30, 100, 300})
+   {
+      std::vector<segment_2> red = layer_segments(squares(n, 0)), blue = layer_segments(squares(n, 0.05));
+      size_t segments = red.size() + blue.size();
+
+      size_t pairs = 0;
+      double sweep = bench::measure([&]()
+      {
+         pairs = 0;
+         for_each_red_blue_intersection(red, blue, [&](size_t, size_t, point_2 const &) { ++pairs; });
+      }, 1);
+      std::printf("%zu segments, %zu red blue pairs\n", segments, pairs);
+      bench::report("  red blue sweep, per segment", sweep, segments);
+
+      std::vector<segment_2> all(red);
+      all.insert(all.end(), blue.begin(), blue.end());
+      double plain = bench::measure([&]()
+      {
+         size_t count = 0;
+         for_each_intersection(all, [&](size_t, size_t, point_2 const &) { ++count; });
+         bench::consume(count);
+      }, 1);
+      bench::report("  sweep of all segments, per segment", plain, segments);
+
+      if (n > 100)
+         continue;
+
+      double every = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (segment_2 const & r : red)
+            for (segment_2 const & b : blue)
+               count += has_intersection(r, b);
+         bench::consume(count);
+      }, 1);
+      bench::report("  every red blue pair, per segment", every, segments);
+   }
+}
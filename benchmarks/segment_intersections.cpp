@@ -0,0 +1,54 @@
+#include <vector>
+#include <random>
+#include <cstdio>
+
+#include <cg/intersections/bentley_ottmann.h>
+
+#include "bench_util.h"
+
+using namespace cg;
+
+// all intersecting pairs of short random segments by the sweep and by testing every pair
+
+static std::vector<segment_2> random_segments(std::mt19937 & gen, size_t n, double length)
+{
+   std::uniform_real_distribution<double> coord(0, 1000), delta(-length, length);
+   std::vector<segment_2> segments;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen));
+      segments.push_back(segment_2(a, point_2(a.x + delta(gen), a.y + delta(gen))));
+   }
+   return segments;
+}
+
+int main()
+{
+   std::mt19937 gen(0);
+   for (size_t n : {1000, 10000, 100000})
+   {
+      std::vector<segment_2> segments = random_segments(gen, n, 5000. / std::sqrt(double(n)));
+
+      size_t pairs = 0;
+      double sweep = bench::measure([&]()
+      {
+         pairs = 0;
+         for_each_intersection(segments, [&](size_t, size_t, point_2 const &) { ++pairs; });
+      }, 1);
+      std::printf("%zu segments, %zu intersecting pairs\n", n, pairs);
+      bench::report("  sweep, per segment", sweep, n);
+
+      if (n > 10000)
+         continue;
+
+      double all = bench::measure([&]()
+      {
+         size_t count = 0;
+         for (size_t i = 0; i != n; ++i)
+            for (size_t j = i + 1; j != n; ++j)
+               count += has_intersection(segments[i], segments[j]);
+         bench::consume(count);
+      }, 1);
+      bench::report("  every pair, per segment", all, n);
+   }
+}
@@ -8,6 +8,7 @@
 
 #include <cg/dcel/kirkpatrick.h>
 
+#include <memory>
 #include <queue>
 #include <iostream>
 #include <cmath>
@@ -19,6 +20,7 @@ using cg::vertex;
 using cg::edge;
 using cg::triangle_k;
 using cg::node_triangle;
+using cg::no_index;
 
 using cg::point_2f;
 using cg::point_2;
@@ -29,6 +31,7 @@ struct dcel_viewer : cg::visualization::viewer_adapter
         : kl(line{0, -1, 0}, line{1, 0, 0})
         , points_seted(0)
         , mode(line_mode)
+        , face_edge(no_index)
         , in_color(false), show_triangulation(false)
         , lvl(0)
     {
@@ -55,23 +58,18 @@ struct dcel_viewer : cg::visualization::viewer_adapter
         drawer.draw_point(p2, 4);
     }
 
-    void draw_ray(const std::shared_ptr<edge> & e, QColor ray_color,
+    void draw_ray(const DCEL & dcel, uint32_t e, QColor ray_color,
                   cg::visualization::drawer_type & drawer) const
     {
-        point_2 v;
-        if (e->origin->line1) {
-            v = cg::intersection_point<double>(*e->origin->line1, *e->origin->line2);
-        } else {
-            v = cg::intersection_point<double>(*e->next->origin->line1, *e->next->origin->line2);
-        }
-        double x = -e->line_link->b, y = e->line_link->a;
+        point_2 v = dcel.vertex_point(dcel.not_inf_vertex(e));
+        double x = -dcel.edge_line(e).b, y = dcel.edge_line(e).a;
         double px = x / std::sqrt(x * x + y * y);
         double py = y / std::sqrt(x * x + y * y);
 
         double r = 500;
         point_2 u = point_2{v.x + r * px, v.y + r * py};
 
-        if (e->origin->line1) {
+        if (!dcel.is_inf(dcel.origin(e))) {
             draw_shift_edge(v, u, ray_color, drawer);
         } else {
             draw_shift_edge(u, v, ray_color, drawer);
@@ -102,45 +100,44 @@ struct dcel_viewer : cg::visualization::viewer_adapter
 
     void bfs_draw(cg::visualization::drawer_type & drawer, const DCEL & dcel) const
     {
-        auto visited = std::vector<int>(dcel.max_vertex);
-        std::queue<std::shared_ptr<vertex>> q;
-        auto s = dcel.inf_node;
-        visited[s->id] = 1;
+        auto visited = std::vector<int>(dcel.vertices.size());
+        std::queue<uint32_t> q;
+        uint32_t s = dcel.inf_node;
+        visited[s] = 1;
         q.push(s);
 
         while (!q.empty()) {
-            auto v = q.front();
+            uint32_t v = q.front();
             q.pop();
 
-            if (v->line1) { // not inf_node
+            if (!dcel.is_inf(v)) {
                 drawer.set_color(Qt::red);
-                drawer.draw_point(cg::intersection_point<double>(*v->line1, *v->line2), 5);
+                drawer.draw_point(dcel.vertex_point(v), 5);
             }
 
-            auto out_edge = v->e;
+            uint32_t out_edge = dcel.vertices[v].e;
             do {
-                //std::cout << out_edge->id << std::endl;
-                auto u = out_edge->next->origin;
-                if (!visited[u->id]) {
+                uint32_t u = dcel.origin(dcel.next(out_edge));
+                if (!visited[u]) {
                     q.push(u);
-                    visited[u->id] = 1;
+                    visited[u] = 1;
                 }
-                if (!v->line1 || !u->line1) {
-                    draw_ray(out_edge, Qt::yellow, drawer);
+                if (dcel.is_inf(v) || dcel.is_inf(u)) {
+                    draw_ray(dcel, out_edge, Qt::yellow, drawer);
                 } else {
-                    auto p1 = cg::intersection_point<double>(*v->line1, *v->line2);
-                    auto p2 = cg::intersection_point<double>(*u->line1, *u->line2);
-                    if (out_edge->hull_edge) {
+                    auto p1 = dcel.vertex_point(v);
+                    auto p2 = dcel.vertex_point(u);
+                    if (dcel.edges[out_edge].hull_edge) {
                         draw_shift_edge(p1, p2, Qt::darkGreen, drawer);
-                    } else if (out_edge->triangle_edge) {
+                    } else if (dcel.edges[out_edge].triangle_edge) {
                         drawer.set_color(QColor(255, 69, 0));
                         drawer.draw_line(p1, p2, 1);
                     } else {
                         draw_shift_edge(p1, p2, Qt::yellow, drawer);
                     }
                 }
-                out_edge = out_edge->twin->next;
-            } while (out_edge->id != v->e->id);
+                out_edge = dcel.next(dcel.twin(out_edge));
+            } while (out_edge != dcel.vertices[v].e);
         }
     }
 
@@ -164,8 +161,8 @@ struct dcel_viewer : cg::visualization::viewer_adapter
     {
         drawer.set_color(QColor(175, 238, 238)); // paleturquoise
         for (int i = 0; i < 3; i++) {
-            point_2 p1 = cg::intersection_point<double>(*t[i].l1, *t[i].l2);
-            point_2 p2 = cg::intersection_point<double>(*t[(i + 1) % 3].l1, *t[(i + 1) % 3].l2);
+            point_2 p1 = cg::intersection_point<double>(t[i].l1, t[i].l2);
+            point_2 p2 = cg::intersection_point<double>(t[(i + 1) % 3].l1, t[(i + 1) % 3].l2);
             drawer.draw_line(p1, p2, 3.3);
         }
     }
@@ -174,17 +171,17 @@ struct dcel_viewer : cg::visualization::viewer_adapter
     {
         int rem = kl.levels.size() - lvl - 1;
         line l1(1, 0, -face_point->x), l2(0, 1, -face_point->y);
-        std::shared_ptr<node_triangle> node = kl.root;
+        const node_triangle * node = &kl.nodes[kl.root];
 
-        while (!node->is_leaf && node->depth > kl.root->depth - rem) {
-            for (auto child : node->children) {
-                if (cg::triangle_contains_convex_point(*child->t, l1, l2)) {
-                    node = child;
+        while (!node->is_leaf && node->depth > kl.nodes[kl.root].depth - rem) {
+            for (uint32_t child : node->children) {
+                if (cg::triangle_contains_convex_point(kl.nodes[child].t, l1, l2)) {
+                    node = &kl.nodes[child];
                     break;
                 }
             }
         }
-        draw_triangle(*node->t, drawer);
+        draw_triangle(node->t, drawer);
     }
 
     void draw(cg::visualization::drawer_type & drawer) const
@@ -203,41 +200,41 @@ struct dcel_viewer : cg::visualization::viewer_adapter
         if (points_seted == 2) {
             draw_blue_line(drawer);
             if (in_color) {
-                std::vector<std::shared_ptr<edge>> intersected_edges;
-                kl.dcel.get_intersected_edges(line_by_points(l1, l2), intersected_edges);
+                const DCEL & dcel = kl.dcel;
+                std::vector<uint32_t> intersected_edges;
+                dcel.get_intersected_edges(line_by_points(l1, l2), intersected_edges);
 
                 drawer.set_color(Qt::blue);
-                for (auto e : intersected_edges) {
-                    auto vu = e;
+                for (uint32_t e : intersected_edges) {
+                    uint32_t vu = e;
                     do {
-                        auto v = vu->origin;
-                        auto u = vu->next->origin;
-                        if (!v->line1 || !u->line1) {
-                            draw_ray(vu, Qt::blue, drawer);
+                        if (dcel.is_ray(vu)) {
+                            draw_ray(dcel, vu, Qt::blue, drawer);
                         } else {
-                            auto p1 = cg::intersection_point<double>(*v->line1, *v->line2);
-                            auto p2 = cg::intersection_point<double>(*u->line1, *u->line2);
+                            auto p1 = dcel.vertex_point(dcel.origin(vu));
+                            auto p2 = dcel.vertex_point(dcel.origin(dcel.next(vu)));
                             draw_shift_edge(p1, p2, Qt::blue, drawer);
                         }
-                        vu = vu->next;
-                    } while (vu->id != e->id);
+                        vu = dcel.next(vu);
+                    } while (vu != e);
                 }
             }
         }
 
-        if (face_edge) {
+        if (face_edge != no_index) {
             if (!show_triangulation) {
-                auto e = face_edge;
+                const DCEL & dcel = kl.dcel;
+                uint32_t e = face_edge;
                 do {
-                    if (!e->origin->line1 || !e->next->origin->line1) {
-                        draw_ray(e, Qt::blue, drawer);
+                    if (dcel.is_ray(e)) {
+                        draw_ray(dcel, e, Qt::blue, drawer);
                     } else {
-                        auto p1 = cg::intersection_point<double>(*e->origin->line1, *e->origin->line2);
-                        auto p2 = cg::intersection_point<double>(*e->next->origin->line1, *e->next->origin->line2);
+                        auto p1 = dcel.vertex_point(dcel.origin(e));
+                        auto p2 = dcel.vertex_point(dcel.origin(dcel.next(e)));
                         draw_shift_edge(p1, p2, Qt::blue, drawer);
                     }
-                    e = e->next;
-                } while (e->id != face_edge->id);
+                    e = dcel.next(e);
+                } while (e != face_edge);
             } else {
                 if (face_point) {
                     draw_triangle_level(drawer);
@@ -246,8 +243,8 @@ struct dcel_viewer : cg::visualization::viewer_adapter
         }
 
         if (show_triangulation) {
-            for (auto v : deleted_vertices[lvl]) {
-                auto p = cg::intersection_point<double>(*v->line1, *v->line2);
+            for (uint32_t v : deleted_vertices[lvl]) {
+                auto p = kl.levels[lvl].dcel.vertex_point(v);
                 drawer.set_color(Qt::darkMagenta);
                 drawer.draw_point(p, 10);
             }
@@ -338,14 +335,14 @@ struct dcel_viewer : cg::visualization::viewer_adapter
             kl = kirkpatrick_localization(line{1, -1, 0}, line{-1, -1, 0});
             kl.build_triangulation(deleted_vertices);
             points_seted = 0;
-            face_edge = std::shared_ptr<edge>();
+            face_edge = no_index;
             face_point = nullptr;
             break;
         case Qt::Key_H:
             kl = kirkpatrick_localization(line{0, -1, 0}, line{1, 0, 0});
             kl.build_triangulation(deleted_vertices);
             points_seted = 0;
-            face_edge = std::shared_ptr<edge>();
+            face_edge = no_index;
             face_point = nullptr;
             break;
         case Qt::Key_T:
@@ -354,7 +351,7 @@ struct dcel_viewer : cg::visualization::viewer_adapter
             break;
         case Qt::Key_L:
             mode = line_mode;
-            face_edge = std::shared_ptr<edge>();
+            face_edge = no_index;
             face_point = nullptr;
             break;
         case Qt::Key_F:
@@ -396,13 +393,13 @@ private:
     };
 
     point_mode mode;
-    std::shared_ptr<edge> face_edge;
+    uint32_t face_edge;
 
     bool in_color;
     bool show_triangulation;
 
     int lvl;
-    std::vector< std::vector< std::shared_ptr<vertex> > > deleted_vertices;
+    std::vector< std::vector<uint32_t> > deleted_vertices;
 };
 
 int main(int argc, char ** argv)
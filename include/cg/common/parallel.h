@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace cg {
+namespace common
+{
+   inline size_t hardware_threads()
+   {
+      size_t n = std::thread::hardware_concurrency();
+      return n ? n : 1;
+   }
+
+   // Calls f(first, last) for consecutive chunks of [0, n) of at most grain items.
+   // Chunks are handed out through a shared counter, so a thread that is done early takes the next one.
+   // threads == 0 means one thread per core; with one thread (or one chunk) f runs on the caller.
+   template <class F>
+   void parallel_for(size_t n, size_t grain, F f, size_t threads = 0)
+   {
+      if (n == 0)
+         return;
+
+      grain = std::max<size_t>(grain, 1);
+      size_t chunks = (n + grain - 1) / grain;
+      if (threads == 0)
+         threads = hardware_threads();
+      threads = std::min(threads, chunks);
+
+      if (threads == 1)
+      {
+         f(size_t(0), n);
+         return;
+      }
+
+      std::atomic<size_t> next(0);
+      auto worker = [&]()
+      {
+         for (size_t c = next++; c < chunks; c = next++)
+            f(c * grain, std::min(n, (c + 1) * grain));
+      };
+
+      std::vector<std::thread> pool;
+      for (size_t l = 1; l != threads; ++l)
+         pool.emplace_back(worker);
+      worker();
+      for (std::thread & t : pool)
+         t.join();
+   }
+
+   // std::sort on equal slices in parallel followed by pairwise merges
+   template <class RandIter, class Compare>
+   void parallel_sort(RandIter p, RandIter q, Compare comp, size_t threads = 0)
+   {
+      size_t n = q - p;
+      if (threads == 0)
+         threads = hardware_threads();
+      threads = std::min(threads, std::max<size_t>(n / 65536, 1));
+
+      size_t grain = (n + threads - 1) / std::max<size_t>(threads, 1);
+      parallel_for(n, grain, [&](size_t first, size_t last) { std::sort(p + first, p + last, comp); }, threads);
+
+      for (size_t width = grain; width < n; width *= 2)
+      {
+         size_t pairs = (n + 2 * width - 1) / (2 * width);
+         parallel_for(pairs, 1, [&](size_t first, size_t last)
+         {
+            for (size_t l = first; l != last; ++l)
+            {
+               size_t lo = l * 2 * width, mid = std::min(n, lo + width), hi = std::min(n, lo + 2 * width);
+               std::inplace_merge(p + lo, p + mid, p + hi, comp);
+            }
+         }, threads);
+      }
+   }
+}}
@@ -1,679 +1,983 @@
 #pragma once
 
 #include <cg/primitives/line_triangle.h>
+#include <cg/common/parallel.h>
 #include <cg/primitives/point3d.h>
+#include <cg/primitives/rectangle.h>
 #include <cg/io/point.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <queue>
+#include <vector>
 
 namespace cg {
 
-    struct vertex;
-    struct node_triangle;
+    // "no vertex / edge / face / line" in the index fields of the DCEL records
+    const uint32_t no_index = uint32_t(-1);
 
+    // All records refer to each other by their index in the DCEL arrays,
+    // so a DCEL is copied (and freed) as a handful of flat vectors.
     struct edge
     {
-        int id;
-        std::shared_ptr<vertex> origin;
-        std::shared_ptr<edge> twin, prev, next;
-        std::shared_ptr<line> line_link;
-        std::shared_ptr<node_triangle> triangle_link;
+        uint32_t origin, twin, prev, next;
+        uint32_t line_link;     // index in DCEL::lines
+        uint32_t face;
+        uint32_t triangle_link; // node of the kirkpatrick DAG
         bool hull_edge;
         bool triangle_edge;
 
         edge()
-            : hull_edge(false), triangle_edge(false)
+            : origin(no_index), twin(no_index), prev(no_index), next(no_index)
+            , line_link(no_index), face(no_index), triangle_link(no_index)
+            , hull_edge(false), triangle_edge(false)
         {}
-
-        edge(int & num)
-            : id(num), hull_edge(false), triangle_edge(false)
-        {
-            num++;
-        }
     };
 
     struct vertex
     {
-        int id;
-        std::shared_ptr<line> line1, line2;
-        std::shared_ptr<edge> e;
-
-        vertex() {}
-
-        vertex(int & num)
-            : id(num)
-        {
-            num++;
-        }
+        uint32_t line1, line2; // the infinite vertex has no lines
+        uint32_t e;
 
-        vertex(const std::shared_ptr<line> & line1, const std::shared_ptr<line> & line2, int & num)
-            : id(num), line1(line1), line2(line2)
-        {
-            num++;
-        }
+        vertex(uint32_t line1 = no_index, uint32_t line2 = no_index)
+            : line1(line1), line2(line2), e(no_index)
+        {}
     };
 
-    struct node_triangle
+    struct face
     {
-        std::shared_ptr<triangle_k> t;
-        std::shared_ptr<edge> node_edge;
-        std::vector<std::shared_ptr<node_triangle>> children;
-        bool is_leaf;
-        int depth;
+        uint32_t e;        // some half-edge of the boundary
+        rectangle_2 bbox;  // of the vertices, maximal for unbounded faces
 
-        node_triangle() {}
-
-        node_triangle(const triangle_k & tri)
-            : is_leaf(false)
-        {
-            t = std::make_shared<triangle_k>(tri);
-        }
-
-        node_triangle(const std::shared_ptr<triangle_k> & t)
-            : t(t), is_leaf(false)
+        face(uint32_t e = no_index)
+            : e(e)
         {}
     };
 
-    inline bool is_ray(const std::shared_ptr<edge> & e)
-    {
-        return !e->origin->line1 || !e->next->origin->line2;
-    }
-
-    inline std::shared_ptr<vertex> not_inf_vertex(const std::shared_ptr<edge> & e)
-    {
-        return (e->origin->line1 ? e->origin : e->next->origin);
-    }
-
     struct DCEL
     {
-        std::shared_ptr<vertex> inf_node;
-
-        int max_vertex, max_edges;
-        std::vector<std::shared_ptr<line>> all_lines;
-
-        DCEL() {}
+        std::vector<line> lines;     // lines of the edges, reversed copies included
+        std::vector<line> all_lines; // lines the arrangement was built from
+        std::vector<vertex> vertices;
+        std::vector<line_cross> crossings; // of the vertex lines, by vertex, for the predicates
+        std::vector<edge> edges;
+        // faces are kept up to date by the constructors and add_line / add_line_in_triangle,
+        // edges added on top of that (like triangulation edges) are left without a face
+        std::vector<face> faces;
+        uint32_t inf_node;
+
+        DCEL()
+            : inf_node(no_index)
+        {}
 
         DCEL(const line & line1, const line & line2)
-            : max_vertex(0), max_edges(0)
         {
-            auto l1 = std::make_shared<line>(line1);
-            auto l2 = std::make_shared<line>(line2);
-            if (orientation(point_2{0, 0}, point_2{-l1->b, l1->a}, point_2{-l2->b, l2->a}) == CG_RIGHT) {
+            line l1 = line1, l2 = line2;
+            if (orientation(point_2{0, 0}, point_2{-l1.b, l1.a}, point_2{-l2.b, l2.a}) == CG_RIGHT) {
                 std::swap(l1, l2);
             }
+            uint32_t il1 = new_line(l1), il2 = new_line(l2);
 
-            inf_node = std::make_shared<vertex>(
-                std::shared_ptr<line>(), std::shared_ptr<line>(), max_vertex
-            );
-
-            auto inner_vertex = std::make_shared<vertex>(l1, l2, max_vertex);
+            inf_node = new_vertex(no_index, no_index);
+            uint32_t inner_vertex = new_vertex(il1, il2);
 
-            auto edges = std::vector<std::shared_ptr<edge>>();
             for (int i = 0; i < 8; i++) {
-                edges.push_back(std::make_shared<edge>(max_edges));
-            }
-
-            for (int i = 0; i < 8; i += 2) {
-                edges[i]->origin = inf_node;
-                edges[i + 1]->origin = inner_vertex;
-                edges[i]->twin = edges[i + 1];
-                edges[i + 1]->twin = edges[i];
-                edges[i]->next = edges[(i + 7) % 8];
-                edges[i]->prev = edges[(i + 7) % 8];
-                edges[i + 1]->next = edges[(i + 2) % 8];
-                edges[i + 1]->prev = edges[(i + 2) % 8];
-
-                if (i % 4 == 0) {
-                    edges[i]->line_link = l1;
-                    edges[i + 1]->line_link = l1;
-                } else {
-                    edges[i]->line_link = l2;
-                    edges[i + 1]->line_link = l2;
-                }
+                new_edge();
+            }
 
+            for (uint32_t i = 0; i < 8; i += 2) {
+                edge & e0 = edges[i];
+                edge & e1 = edges[i + 1];
+                e0.origin = inf_node;
+                e1.origin = inner_vertex;
+                e0.twin = i + 1;
+                e1.twin = i;
+                e0.next = e0.prev = (i + 7) % 8;
+                e1.next = e1.prev = (i + 2) % 8;
+
+                uint32_t l = (i % 4 == 0 ? il1 : il2);
                 if (i >= 4) {
-                    auto l = std::make_shared<line>(*edges[i]->line_link);
-                    l->a *= -1;
-                    l->b *= -1;
-                    l->c *= -1;
-                    edges[i]->line_link = l;
-                    edges[i + 1]->line_link = l;
+                    l = reversed_line(l);
                 }
+                e0.line_link = e1.line_link = l;
             }
 
-            inf_node->e = edges[0];
-            inner_vertex->e = edges[1];
+            vertices[inf_node].e = 0;
+            vertices[inner_vertex].e = 1;
 
             all_lines.push_back(l1);
             all_lines.push_back(l2);
+            label_faces();
         }
 
-        DCEL(const std::vector<std::shared_ptr<line>> & lines)
-            : max_vertex(0), max_edges(0)
+        // arrangement of the lines clipped by a triangle around all its vertices
+        DCEL(const std::vector<line> & input_lines)
+            : all_lines(input_lines)
         {
-            auto edge_lines = std::vector<std::shared_ptr<line>>(3);
-            auto vertices = std::vector<std::shared_ptr<vertex>>(3);
-            auto edges = std::vector<std::shared_ptr<edge>>(6);
-
             line down(0, 1, 0), left(1, 0, 0), diag(1, 1, 0);
-            edge_lines[0] = std::make_shared<line>(left);
-            edge_lines[1] = std::make_shared<line>(down);
-            edge_lines[2] = std::make_shared<line>(diag);
 
-            std::vector<std::shared_ptr<line>> new_lines(lines);
-            find_border_line(*edge_lines[0], 200, 1, new_lines);
-            new_lines.push_back(edge_lines[0]);
-            find_border_line(*edge_lines[1], 200, 1, new_lines);
-            new_lines.push_back(edge_lines[1]);
-            find_border_line(*edge_lines[2], -200, -1, new_lines);
+            std::vector<line> border_lines(input_lines);
+            find_border_line(left, 200, 1, border_lines);
+            border_lines.push_back(left);
+            find_border_line(down, 200, 1, border_lines);
+            border_lines.push_back(down);
+            find_border_line(diag, -200, -1, border_lines);
 
-            vertices[0] = std::make_shared<vertex>(edge_lines[0], edge_lines[2], max_vertex);
-            vertices[1] = std::make_shared<vertex>(edge_lines[0], edge_lines[1], max_vertex);
-            vertices[2] = std::make_shared<vertex>(edge_lines[1], edge_lines[2], max_vertex);
+            uint32_t edge_lines[3] = {new_line(left), new_line(down), new_line(diag)};
+
+            new_vertex(edge_lines[0], edge_lines[2]);
+            new_vertex(edge_lines[0], edge_lines[1]);
+            new_vertex(edge_lines[1], edge_lines[2]);
 
             for (int i = 0; i < 6; i++) {
-                edges[i] = std::make_shared<edge>(max_edges);
-                if (i % 2 == 0) {
-                    edges[i]->hull_edge = true;
-                }
+                edges[new_edge()].hull_edge = (i % 2 == 0);
             }
 
-            for (int i = 0; i < 6; i += 2) {
-                vertices[i / 2]->e = edges[(i + 4) % 6];
+            for (uint32_t i = 0; i < 6; i += 2) {
+                vertices[i / 2].e = (i + 4) % 6;
+
+                edge & e0 = edges[i];
+                edge & e1 = edges[i + 1];
+                e0.origin = ((i + 2) / 2) % 3;
+                e1.origin = i / 2;
+                e0.twin = i + 1;
+                e1.twin = i;
+                e0.line_link = e1.line_link = edge_lines[i / 2];
+                e0.next = (i + 4) % 6;
+                e1.next = (i + 3) % 6;
+                e0.prev = (i + 2) % 6;
+                e1.prev = (i + 4) % 6;
+            }
 
-                edges[i]->origin = vertices[((i + 2) / 2) % 3];
-                edges[i + 1]->origin = vertices[i / 2];
+            inf_node = 0;
+            label_faces();
 
-                edges[i]->twin = edges[i + 1];
-                edges[i + 1]->twin = edges[i];
+            for (const line & l : input_lines) {
+                add_line_in_triangle(l);
+            }
+        }
 
-                edges[i]->line_link = edge_lines[i / 2];
-                edges[i + 1]->line_link = edge_lines[i / 2];
+        uint32_t new_line(const line & l)
+        {
+            lines.push_back(l);
+            return lines.size() - 1;
+        }
 
-                edges[i]->next = edges[(i + 4) % 6];
-                edges[i + 1]->next = edges[(i + 3) % 6];
+        uint32_t reversed_line(uint32_t l)
+        {
+            line rev = lines[l];
+            rev.inverse_vector();
+            return new_line(rev);
+        }
 
-                edges[i]->prev = edges[(i + 2) % 6];
-                edges[i + 1]->prev = edges[(i + 4) % 6];
-            }
+        uint32_t new_vertex(uint32_t line1, uint32_t line2)
+        {
+            vertices.push_back(vertex(line1, line2));
+            crossings.push_back(line1 == no_index ? line_cross() : line_cross(lines[line1], lines[line2]));
+            return vertices.size() - 1;
+        }
 
-            inf_node = vertices[0];
+        uint32_t new_edge()
+        {
+            edges.push_back(edge());
+            return edges.size() - 1;
+        }
 
-            for (auto l : lines) {
-                add_line_in_triangle(*l);
-            }
+        dead_sign direction_orientation(uint32_t l1, uint32_t l2) const
+        {
+            return orientation_2d(-lines[l1].b, lines[l1].a, -lines[l2].b, lines[l2].a);
+        }
+
+        uint32_t origin(uint32_t e) const { return edges[e].origin; }
+        uint32_t twin(uint32_t e) const { return edges[e].twin; }
+        uint32_t next(uint32_t e) const { return edges[e].next; }
+        uint32_t prev(uint32_t e) const { return edges[e].prev; }
 
-            //add_line_in_triangle(*lines[0]);
+        const line & edge_line(uint32_t e) const
+        {
+            return lines[edges[e].line_link];
         }
 
-        void find_border_line(line & l, double d, int sign, const std::vector<std::shared_ptr<line>> & lines)
+        bool is_inf(uint32_t v) const
         {
-            bool all_one_side = false;
-            while (!all_one_side) {
-                all_one_side = true;
-                for (size_t i = 0; i < lines.size() - 1 && all_one_side; i++) {
-                    for (size_t j = i + 1; j < lines.size() && all_one_side; j++) {
-                        if (orientation_2d(lines[i]->a, lines[i]->b, lines[j]->a, lines[j]->b) == ZERO_DEAD) continue;
-                        int line_sign = line_point_sign(l, *lines[i], *lines[j]);
-                        all_one_side = line_sign * sign > 0;
-                    }
-                }
-                if (!all_one_side) {
-                    l.c += d;
-                }
-            }
+            return vertices[v].line1 == no_index;
         }
 
-        void deep_copy_edge(int eid, const std::shared_ptr<edge> & other,
-                            std::vector<std::shared_ptr<vertex>> & vertices,
-                            std::vector<std::shared_ptr<edge>> & edges)
+        bool is_ray(uint32_t e) const
         {
-            if (edges[eid]) return;
-
-            edges[eid] = std::make_shared<edge>();
-            edges[eid]->id = other->id;
-            edges[eid]->line_link = other->line_link;
-            edges[eid]->triangle_link = other->triangle_link;
-            edges[eid]->hull_edge = other->hull_edge;
-            edges[eid]->triangle_edge = other->triangle_edge;
-
-            deep_copy_vertex(other->origin->id, other->origin, vertices, edges);
-            deep_copy_edge(other->twin->id, other->twin, vertices, edges);
-            deep_copy_edge(other->next->id, other->next, vertices, edges);
-            deep_copy_edge(other->prev->id, other->prev, vertices, edges);
-
-            edges[eid]->origin = vertices[other->origin->id];
-            edges[eid]->twin = edges[other->twin->id];
-            edges[eid]->next = edges[other->next->id];
-            edges[eid]->prev = edges[other->prev->id];
+            return is_inf(origin(e)) || is_inf(origin(next(e)));
         }
 
-        void deep_copy_vertex(int vid, const std::shared_ptr<vertex> & other,
-                              std::vector<std::shared_ptr<vertex>> & vertices,
-                              std::vector<std::shared_ptr<edge>> & edges)
+        uint32_t not_inf_vertex(uint32_t e) const
         {
-            if (vertices[vid]) return;
+            return is_inf(origin(e)) ? origin(next(e)) : origin(e);
+        }
 
-            vertices[vid] = std::make_shared<vertex>();
-            vertices[vid]->id = other->id;
-            vertices[vid]->line1 = other->line1;
-            vertices[vid]->line2 = other->line2;
+        point_2 vertex_point(uint32_t v) const
+        {
+            return crossings[v].point();
+        }
 
-            deep_copy_edge(other->e->id, other->e, vertices, edges);
+        triangle_k triangle(uint32_t v, uint32_t u, uint32_t w) const
+        {
+            return triangle_k(vertex_cross(v), vertex_cross(u), vertex_cross(w));
+        }
 
-            vertices[vid]->e = edges[other->e->id];
+        const line_cross & vertex_cross(uint32_t v) const
+        {
+            return crossings[v];
         }
 
-        DCEL(const DCEL & other_dcel) // copy constructor, need for deleting vertices
+        // shifts l by steps of d until every crossing of the lines is on the `sign` side of it.
+        // The crossing extreme along the normal of l is one of the pairs from border_candidates,
+        // so the number of steps is estimated from them and only they are checked exactly
+        void find_border_line(line & l, double d, int sign, const std::vector<line> & lines) const
         {
-            max_vertex = other_dcel.max_vertex;
-            max_edges = other_dcel.max_edges;
-            std::vector<std::shared_ptr<vertex>> vertices(max_vertex);
-            std::vector<std::shared_ptr<edge>> edges(max_edges);
+            std::vector<std::pair<uint32_t, uint32_t>> pairs;
+            border_candidates(l, lines, pairs);
+            if (pairs.empty()) return;
+
+            double extreme = (sign > 0 ? std::numeric_limits<double>::max() : -std::numeric_limits<double>::max());
+            for (const std::pair<uint32_t, uint32_t> & pr : pairs) {
+                point_2 v = intersection_point<double>(lines[pr.first], lines[pr.second]);
+                double t = l.a * v.x + l.b * v.y;
+                extreme = (sign > 0 ? std::min(extreme, t) : std::max(extreme, t));
+            }
 
-            deep_copy_vertex(0, other_dcel.inf_node, vertices, edges);
-            inf_node = vertices[0];
+            auto one_side = [&](double c) {
+                line m(l.a, l.b, c);
+                for (const std::pair<uint32_t, uint32_t> & pr : pairs) {
+                    if (line_point_sign(m, lines[pr.first], lines[pr.second]) * sign <= 0) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            // sign * (extreme + c) > 0 is wanted, the exact checks fix the rounding of the estimate
+            double steps = std::ceil((-extreme - l.c) / d);
+            double k = (std::isfinite(steps) ? std::max(steps, 0.) : 0.);
+            while (!one_side(l.c + k * d)) {
+                k++;
+            }
+            while (k > 0 && one_side(l.c + (k - 1) * d)) {
+                k--;
+            }
+            l.c += k * d;
+        }
+
+        // Pairs of lines among which is the crossing extreme along the normal of l. Sweeping a parallel of l
+        // from far away, the first crossing is between lines adjacent in the order the sweep meets them there:
+        // the order of the normals by angle, lines with parallel normals by offset. Lines parallel to l
+        // are crossed all at once and get paired with one other line.
+        static void border_candidates(const line & l, const std::vector<line> & lines,
+                                      std::vector<std::pair<uint32_t, uint32_t>> & pairs)
+        {
+            std::vector<line> normal(lines); // normals turned to one side of the normal of l
+            std::vector<uint32_t> order, parallel;
+            for (uint32_t i = 0; i < lines.size(); i++) {
+                int side = orientation_2d(l.a, l.b, lines[i].a, lines[i].b);
+                if (side == 0) {
+                    parallel.push_back(i);
+                    continue;
+                }
+                if (side < 0) {
+                    normal[i].inverse_vector();
+                }
+                order.push_back(i);
+            }
 
-            all_lines.resize(other_dcel.all_lines.size());
-            std::copy(other_dcel.all_lines.begin(), other_dcel.all_lines.end(), all_lines.begin());
+            if (!order.empty()) {
+                for (uint32_t i : parallel) {
+                    pairs.push_back(std::make_pair(i, order[0]));
+                }
+            }
+
+            std::sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) {
+                return orientation_2d(normal[i].a, normal[i].b, normal[j].a, normal[j].b) > 0;
+            });
+
+            // offset order inside a group of parallel lines, normals of a group point the same way
+            auto offset_less = [&](uint32_t i, uint32_t j) {
+                const line & m = normal[i], & n = normal[j];
+                return (m.b != 0 ? orientation_2d(n.c, m.c, n.b, m.b) * (m.b > 0 ? 1 : -1)
+                                 : orientation_2d(n.c, m.c, n.a, m.a) * (m.a > 0 ? 1 : -1)) > 0;
+            };
+
+            uint32_t prev_lo = no_index, prev_hi = no_index;
+            for (size_t first = 0; first < order.size(); ) {
+                size_t last = first + 1;
+                uint32_t lo = order[first], hi = order[first];
+                while (last < order.size()
+                       && orientation_2d(normal[order[first]].a, normal[order[first]].b,
+                                         normal[order[last]].a, normal[order[last]].b) == 0) {
+                    if (offset_less(order[last], lo)) lo = order[last];
+                    if (offset_less(hi, order[last])) hi = order[last];
+                    last++;
+                }
+
+                if (prev_lo != no_index) {
+                    pairs.push_back(std::make_pair(prev_lo, lo));
+                    pairs.push_back(std::make_pair(prev_lo, hi));
+                    pairs.push_back(std::make_pair(prev_hi, lo));
+                    pairs.push_back(std::make_pair(prev_hi, hi));
+                }
+                prev_lo = lo;
+                prev_hi = hi;
+                first = last;
+            }
         }
 
-        bool edge_intersects_line(const line & l, const std::shared_ptr<edge> & e) const
+        bool edge_intersects_line(const line & l, uint32_t e) const
         {
             if (is_ray(e)) {
-                auto v = not_inf_vertex(e);
-                return ray_line_intersection(l, *e->line_link, *v->line1, *v->line2);
+                uint32_t v = not_inf_vertex(e);
+                return ray_line_intersection(l, edge_line(e), lines[vertices[v].line1], lines[vertices[v].line2]);
             }
 
-            auto v = e->origin;
-            auto u = e->next->origin;
-            return segment_line_intersection(l, *v->line1, *v->line2, *u->line1, *u->line2);
+            return line_point_sign(l, crossings[origin(e)]) != line_point_sign(l, crossings[origin(next(e))]);
         }
 
-        void add_line(const line & new_line)
+        void add_line(const line & added_line)
         {
-            std::shared_ptr<edge> inf_face_edge;
-            auto e = inf_node->e;
-            auto el = e->line_link;
-            auto l = std::make_shared<line>(new_line);
-            all_lines.push_back(l);
-
-            if (orientation_2d(-el->b, el->a, -l->b, l->a) == NEG_DEAD) {
+            uint32_t first_edge = edges.size();
+            uint32_t inf_face_edge;
+            uint32_t e = vertices[inf_node].e;
+            uint32_t el = edges[e].line_link;
+            uint32_t l = new_line(added_line);
+            all_lines.push_back(added_line);
+
+            if (direction_orientation(el, l) == NEG_DEAD) {
                 inf_face_edge = e;
             } else {
-                auto f = e->twin->next;
-                auto fl = f->line_link;
+                uint32_t f = next(twin(e));
+                uint32_t fl = edges[f].line_link;
 
-                while (orientation_2d(-el->b, el->a, -l->b, l->a) == orientation_2d(-fl->b, fl->a, -l->b, l->a)) {
+                while (direction_orientation(el, l) == direction_orientation(fl, l)) {
                     e = f;
-                    f = f->twin->next;
-                    el = e->line_link;
-                    fl = f->line_link;
+                    f = next(twin(f));
+                    el = edges[e].line_link;
+                    fl = edges[f].line_link;
                 }
 
                 inf_face_edge = f;
             }
 
-            auto crossed_edge = inf_face_edge;
-            while (!edge_intersects_line(new_line, crossed_edge)) {
-                crossed_edge = crossed_edge->next;
+            uint32_t crossed_edge = inf_face_edge;
+            while (!edge_intersects_line(added_line, crossed_edge)) {
+                crossed_edge = next(crossed_edge);
             }
 
-            auto new_vertex = std::make_shared<vertex>(
-                crossed_edge->line_link, l, max_vertex
-            );
+            uint32_t new_vertex_id = new_vertex(edges[crossed_edge].line_link, l);
 
-            auto line_edge1 = std::make_shared<edge>(max_edges); // line segment edges
-            auto line_edge2 = std::make_shared<edge>(max_edges);
-            auto part_edge1 = std::make_shared<edge>(max_edges); // partition half edges
-            auto part_edge2 = std::make_shared<edge>(max_edges);
+            uint32_t line_edge1 = new_edge(); // line segment edges
+            uint32_t line_edge2 = new_edge();
+            uint32_t part_edge1 = new_edge(); // partition half edges
+            uint32_t part_edge2 = new_edge();
 
-            new_vertex->e = part_edge1;
+            vertices[new_vertex_id].e = part_edge1;
+            bool next_is_inf = is_inf(origin(next(crossed_edge)));
 
-            part_edge1->origin = new_vertex;
-            part_edge1->twin = crossed_edge->twin;
-            part_edge1->next = (!crossed_edge->next->origin->line1 ? line_edge2 : crossed_edge->next);
-            part_edge1->prev = line_edge2;
-            part_edge1->line_link = crossed_edge->line_link;
+            edges[part_edge1].origin = new_vertex_id;
+            edges[part_edge1].twin = twin(crossed_edge);
+            edges[part_edge1].next = (next_is_inf ? line_edge2 : next(crossed_edge));
+            edges[part_edge1].prev = line_edge2;
+            edges[part_edge1].line_link = edges[crossed_edge].line_link;
 
-            part_edge2->origin = new_vertex;
-            part_edge2->twin = crossed_edge;
-            part_edge2->next = crossed_edge->twin->next; // !!! may be next in line_edge1
-            // part_edge2->prev -- cannot set now
-            part_edge2->line_link = crossed_edge->line_link;
+            edges[part_edge2].origin = new_vertex_id;
+            edges[part_edge2].twin = crossed_edge;
+            edges[part_edge2].next = next(twin(crossed_edge)); // !!! may be next in line_edge1
+            // part_edge2 prev -- cannot set now
+            edges[part_edge2].line_link = edges[crossed_edge].line_link;
 
-            line_edge1->origin = new_vertex;
-            line_edge1->twin = line_edge2;
-            line_edge1->next = inf_face_edge;
-            line_edge1->prev = crossed_edge;
-            line_edge1->line_link = l;
+            edges[line_edge1].origin = new_vertex_id;
+            edges[line_edge1].twin = line_edge2;
+            edges[line_edge1].next = inf_face_edge;
+            edges[line_edge1].prev = crossed_edge;
+            edges[line_edge1].line_link = l;
 
-            line_edge2->origin = inf_node;
-            line_edge2->twin = line_edge1;
-            line_edge2->next = part_edge1;
-            line_edge2->prev = (!crossed_edge->next->origin->line1 ? part_edge1 : inf_face_edge->prev);
-            line_edge2->line_link = l;
+            edges[line_edge2].origin = inf_node;
+            edges[line_edge2].twin = line_edge1;
+            edges[line_edge2].next = part_edge1;
+            edges[line_edge2].prev = (next_is_inf ? part_edge1 : prev(inf_face_edge));
+            edges[line_edge2].line_link = l;
 
             // redefine inf_node edge
-            if (orientation_2d(-el->b, el->a, -l->b, l->a) == NEG_DEAD) {
-                inf_node->e = line_edge2;
+            if (direction_orientation(el, l) == NEG_DEAD) {
+                vertices[inf_node].e = line_edge2;
             }
 
-            auto face_edge = crossed_edge->twin->next;
-            if (crossed_edge->next->origin->line1) {
-                crossed_edge->next->prev = part_edge1;
-                inf_face_edge->prev->next = line_edge2;
+            uint32_t face_edge = next(twin(crossed_edge));
+            if (!next_is_inf) {
+                edges[next(crossed_edge)].prev = part_edge1;
+                edges[prev(inf_face_edge)].next = line_edge2;
             }
-            inf_face_edge->prev = line_edge1;
+            edges[inf_face_edge].prev = line_edge1;
 
-            crossed_edge->next = line_edge1;
-            crossed_edge->twin->twin = part_edge1;
-            crossed_edge->twin = part_edge2;
+            edges[crossed_edge].next = line_edge1;
+            edges[twin(crossed_edge)].twin = part_edge1;
+            edges[crossed_edge].twin = part_edge2;
 
             do {
-                line_edge1 = std::make_shared<edge>(max_edges); // line segment edges
-                line_edge2 = std::make_shared<edge>(max_edges);
-
-                //line_edge1->origin = new_vertex;
-                line_edge1->twin = line_edge2;
-                line_edge1->next = part_edge2;
-                //line_edge1->prev - cannot set now;
-                line_edge1->line_link = l;
-
-                line_edge2->origin = new_vertex;
-                line_edge2->twin = line_edge1;
-                //line_edge2->next - cannot set now;
-                line_edge2->prev = part_edge1->twin;
-                line_edge2->line_link = l;
-
-                while (face_edge->id != part_edge1->twin->id && !edge_intersects_line(new_line, face_edge)) {
-                    face_edge = face_edge->next;
+                line_edge1 = new_edge(); // line segment edges
+                line_edge2 = new_edge();
+
+                // line_edge1 origin -- cannot set now
+                edges[line_edge1].twin = line_edge2;
+                edges[line_edge1].next = part_edge2;
+                // line_edge1 prev -- cannot set now
+                edges[line_edge1].line_link = l;
+
+                edges[line_edge2].origin = new_vertex_id;
+                edges[line_edge2].twin = line_edge1;
+                // line_edge2 next -- cannot set now
+                edges[line_edge2].prev = twin(part_edge1);
+                edges[line_edge2].line_link = l;
+
+                while (face_edge != twin(part_edge1) && !edge_intersects_line(added_line, face_edge)) {
+                    face_edge = next(face_edge);
                 }
 
-                if (face_edge->id == part_edge1->twin->id) { // end in last half plane
-                    part_edge1->twin->next = part_edge2;
+                if (face_edge == twin(part_edge1)) { // end in last half plane
+                    edges[twin(part_edge1)].next = part_edge2;
 
-                    while (face_edge->origin->line1) {
-                        face_edge = face_edge->next;
+                    while (!is_inf(origin(face_edge))) {
+                        face_edge = next(face_edge);
                     }
                     inf_face_edge = face_edge;
 
-                    part_edge1->twin->next = line_edge2;
-                    part_edge2->prev = line_edge1;
-
-                    auto rev_line = std::make_shared<line>(new_line);
-                    rev_line->a *= -1;
-                    rev_line->b *= -1;
-                    rev_line->c *= -1;
-
-                    line_edge1->line_link = rev_line;
-                    line_edge2->line_link = rev_line;
+                    edges[twin(part_edge1)].next = line_edge2;
+                    edges[part_edge2].prev = line_edge1;
 
-                    line_edge1->origin = inf_node;
-                    line_edge1->prev = inf_face_edge->prev;
-                    line_edge2->next = inf_face_edge;
+                    uint32_t rev_line = reversed_line(l);
+                    edges[line_edge1].line_link = rev_line;
+                    edges[line_edge2].line_link = rev_line;
 
-                    inf_face_edge->prev->next = line_edge1;
-                    inf_face_edge->prev = line_edge2;
+                    edges[line_edge1].origin = inf_node;
+                    edges[line_edge1].prev = prev(inf_face_edge);
+                    edges[line_edge2].next = inf_face_edge;
 
+                    edges[prev(inf_face_edge)].next = line_edge1;
+                    edges[inf_face_edge].prev = line_edge2;
 
                     break;
                 }
 
-                part_edge1->twin->next = line_edge2;
-                part_edge2->prev = line_edge1;
-                part_edge2->next->prev = part_edge2;
+                edges[twin(part_edge1)].next = line_edge2;
+                edges[part_edge2].prev = line_edge1;
+                edges[next(part_edge2)].prev = part_edge2;
 
-                auto new_vertex2 = std::make_shared<vertex>(
-                    face_edge->line_link, l, max_vertex
-                );
+                uint32_t new_vertex2 = new_vertex(edges[face_edge].line_link, l);
 
-                auto new_part_edge1 = std::make_shared<edge>(max_edges); // partition half edges
-                auto new_part_edge2 = std::make_shared<edge>(max_edges);
+                uint32_t new_part_edge1 = new_edge(); // partition half edges
+                uint32_t new_part_edge2 = new_edge();
 
-                line_edge1->prev = face_edge;
-                line_edge2->next = new_part_edge1;
-                line_edge1->origin = new_vertex2;
+                edges[line_edge1].prev = face_edge;
+                edges[line_edge2].next = new_part_edge1;
+                edges[line_edge1].origin = new_vertex2;
 
-                new_vertex2->e = new_part_edge2;
+                vertices[new_vertex2].e = new_part_edge2;
 
-                new_part_edge1->origin = new_vertex2;
-                new_part_edge1->twin = face_edge->twin;
-                new_part_edge1->next = face_edge->next;
-                new_part_edge1->prev = line_edge2;
-                new_part_edge1->line_link = face_edge->line_link;
+                edges[new_part_edge1].origin = new_vertex2;
+                edges[new_part_edge1].twin = twin(face_edge);
+                edges[new_part_edge1].next = next(face_edge);
+                edges[new_part_edge1].prev = line_edge2;
+                edges[new_part_edge1].line_link = edges[face_edge].line_link;
 
-                new_part_edge2->origin = new_vertex2;
-                new_part_edge2->twin = face_edge;
-                new_part_edge2->next = face_edge->twin->next; // remember to reset in last half plane
-                //new_part_edge2->prev - cannot set now;
-                new_part_edge2->line_link = face_edge->line_link;
+                edges[new_part_edge2].origin = new_vertex2;
+                edges[new_part_edge2].twin = face_edge;
+                edges[new_part_edge2].next = next(twin(face_edge)); // remember to reset in last half plane
+                // new_part_edge2 prev -- cannot set now
+                edges[new_part_edge2].line_link = edges[face_edge].line_link;
 
-                face_edge->next->prev = new_part_edge1;
-                face_edge->twin->next->prev = new_part_edge2; // some problems here
-                face_edge->next = line_edge1;
-                //face_edge->twin->next = new_part_edge2;
-                face_edge->twin->twin = new_part_edge1;
-                face_edge->twin = new_part_edge2;
+                edges[next(face_edge)].prev = new_part_edge1;
+                edges[next(twin(face_edge))].prev = new_part_edge2;
+                edges[face_edge].next = line_edge1;
+                edges[twin(face_edge)].twin = new_part_edge1;
+                edges[face_edge].twin = new_part_edge2;
 
                 crossed_edge = face_edge;
-                face_edge = crossed_edge->twin->next;
-                new_vertex = new_vertex2;
+                face_edge = next(twin(crossed_edge));
+                new_vertex_id = new_vertex2;
                 part_edge1 = new_part_edge1;
                 part_edge2 = new_part_edge2;
             } while (true);
+
+            relabel_faces(first_edge);
         }
 
-        void add_line_in_triangle(const line & new_line)
+        void add_line_in_triangle(const line & added_line)
         {
-            auto l = std::make_shared<line>(new_line);
-            auto crossed_edge = inf_node->e;
+            uint32_t first_edge = edges.size();
+            uint32_t l = new_line(added_line);
+            uint32_t crossed_edge = vertices[inf_node].e;
 
-            while (!edge_intersects_line(new_line, crossed_edge)) {
-                crossed_edge = crossed_edge->next;
+            while (!edge_intersects_line(added_line, crossed_edge)) {
+                crossed_edge = next(crossed_edge);
             }
 
-            std::shared_ptr<vertex> new_vertex = std::make_shared<vertex>(
-                crossed_edge->line_link, l, max_vertex
-            );
+            uint32_t new_vertex_id = new_vertex(edges[crossed_edge].line_link, l);
 
-            std::shared_ptr<edge> part_edge1 = std::make_shared<edge>(max_edges); // partition half edges
-            std::shared_ptr<edge> part_edge2 = std::make_shared<edge>(max_edges);
+            uint32_t part_edge1 = new_edge(); // partition half edges
+            uint32_t part_edge2 = new_edge();
 
-            new_vertex->e = part_edge1;
+            vertices[new_vertex_id].e = part_edge1;
 
-            part_edge1->origin = new_vertex;
-            part_edge1->twin = crossed_edge->twin;
-            part_edge1->next = crossed_edge->next;
-            part_edge1->prev = crossed_edge;
-            part_edge1->line_link = crossed_edge->line_link;
-            part_edge1->hull_edge = true;
+            edges[part_edge1].origin = new_vertex_id;
+            edges[part_edge1].twin = twin(crossed_edge);
+            edges[part_edge1].next = next(crossed_edge);
+            edges[part_edge1].prev = crossed_edge;
+            edges[part_edge1].line_link = edges[crossed_edge].line_link;
+            edges[part_edge1].hull_edge = true;
 
-            part_edge2->origin = new_vertex;
-            part_edge2->twin = crossed_edge;
-            part_edge2->next = crossed_edge->twin->next;
-            //part_edge2->prev -- can't set now
-            part_edge2->line_link = crossed_edge->line_link;
+            edges[part_edge2].origin = new_vertex_id;
+            edges[part_edge2].twin = crossed_edge;
+            edges[part_edge2].next = next(twin(crossed_edge));
+            // part_edge2 prev -- can't set now
+            edges[part_edge2].line_link = edges[crossed_edge].line_link;
 
-            auto face_edge = crossed_edge->twin->next;
-            crossed_edge->next->prev = part_edge1;
-            crossed_edge->next = part_edge1;
-            crossed_edge->twin->next->prev = part_edge2;
-            //crossed_edge->twin->next -- can't set now
-            crossed_edge->twin->twin = part_edge1;
-            crossed_edge->twin = part_edge2;
+            uint32_t face_edge = next(twin(crossed_edge));
+            edges[next(crossed_edge)].prev = part_edge1;
+            edges[crossed_edge].next = part_edge1;
+            edges[next(twin(crossed_edge))].prev = part_edge2;
+            // twin(crossed_edge) next -- can't set now
+            edges[twin(crossed_edge)].twin = part_edge1;
+            edges[crossed_edge].twin = part_edge2;
 
             do {
-                std::shared_ptr<edge> line_edge1 = std::make_shared<edge>(max_edges); // line segment edges
-                std::shared_ptr<edge> line_edge2 = std::make_shared<edge>(max_edges);
-
-                part_edge1->twin->next = line_edge2;
-                part_edge2->prev = line_edge1;
-
-                // line_edge1->origin -- can't set now
-                line_edge1->twin = line_edge2;
-                line_edge1->next = part_edge2;
-                //line_edge1->prev -- can't set now
-                line_edge1->line_link = l;
-
-                line_edge2->origin = new_vertex;
-                line_edge2->twin = line_edge1;
-                // line_edge2->next -- can't set noww
-                line_edge2->prev = part_edge1->twin;
-                line_edge2->line_link = l;
-
-                while (face_edge->id != part_edge1->twin->id && !edge_intersects_line(new_line, face_edge)) {
-                    face_edge = face_edge->next;
+                uint32_t line_edge1 = new_edge(); // line segment edges
+                uint32_t line_edge2 = new_edge();
+
+                edges[twin(part_edge1)].next = line_edge2;
+                edges[part_edge2].prev = line_edge1;
+
+                // line_edge1 origin -- can't set now
+                edges[line_edge1].twin = line_edge2;
+                edges[line_edge1].next = part_edge2;
+                // line_edge1 prev -- can't set now
+                edges[line_edge1].line_link = l;
+
+                edges[line_edge2].origin = new_vertex_id;
+                edges[line_edge2].twin = line_edge1;
+                // line_edge2 next -- can't set now
+                edges[line_edge2].prev = twin(part_edge1);
+                edges[line_edge2].line_link = l;
+
+                while (face_edge != twin(part_edge1) && !edge_intersects_line(added_line, face_edge)) {
+                    face_edge = next(face_edge);
                 }
 
-                std::shared_ptr<vertex> new_vertex2 = std::make_shared<vertex>(
-                    face_edge->line_link, l, max_vertex
-                );
+                uint32_t new_vertex2 = new_vertex(edges[face_edge].line_link, l);
 
-                std::shared_ptr<edge> new_part_edge1 = std::make_shared<edge>(max_edges); // partition half edges
-                std::shared_ptr<edge> new_part_edge2 = std::make_shared<edge>(max_edges);
+                uint32_t new_part_edge1 = new_edge(); // partition half edges
+                uint32_t new_part_edge2 = new_edge();
 
-                line_edge1->origin = new_vertex2;
-                line_edge1->prev = face_edge;
-                line_edge2->next = new_part_edge1;
+                edges[line_edge1].origin = new_vertex2;
+                edges[line_edge1].prev = face_edge;
+                edges[line_edge2].next = new_part_edge1;
 
-                new_vertex2->e = new_part_edge2;
+                vertices[new_vertex2].e = new_part_edge2;
 
-                new_part_edge1->origin = new_vertex2;
-                new_part_edge1->twin = face_edge->twin;
-                new_part_edge1->next = face_edge->next;
-                new_part_edge1->prev = line_edge2;
-                new_part_edge1->line_link = face_edge->line_link;
+                edges[new_part_edge1].origin = new_vertex2;
+                edges[new_part_edge1].twin = twin(face_edge);
+                edges[new_part_edge1].next = next(face_edge);
+                edges[new_part_edge1].prev = line_edge2;
+                edges[new_part_edge1].line_link = edges[face_edge].line_link;
 
-                new_part_edge2->origin = new_vertex2;
-                new_part_edge2->twin = face_edge;
-                new_part_edge2->next = face_edge->twin->next;
-                new_part_edge2->prev = new_part_edge1->twin; // this may change later
-                new_part_edge2->line_link = face_edge->line_link;
+                edges[new_part_edge2].origin = new_vertex2;
+                edges[new_part_edge2].twin = face_edge;
+                edges[new_part_edge2].next = next(twin(face_edge));
+                edges[new_part_edge2].prev = twin(face_edge); // this may change later
+                edges[new_part_edge2].line_link = edges[face_edge].line_link;
 
-                face_edge->next->prev = new_part_edge1;
-                face_edge->twin->next->prev = new_part_edge2; // some problems here
-                face_edge->next = line_edge1;
-                face_edge->twin->next = new_part_edge2;
-                face_edge->twin->twin = new_part_edge1;
-                face_edge->twin = new_part_edge2;
+                edges[next(face_edge)].prev = new_part_edge1;
+                edges[next(twin(face_edge))].prev = new_part_edge2;
+                edges[face_edge].next = line_edge1;
+                edges[twin(face_edge)].next = new_part_edge2;
+                edges[twin(face_edge)].twin = new_part_edge1;
+                edges[face_edge].twin = new_part_edge2;
 
-                if (new_part_edge1->twin->hull_edge) { // end in last half plane
-                    new_part_edge2->hull_edge = true;
+                if (edges[twin(new_part_edge1)].hull_edge) { // end in last half plane
+                    edges[new_part_edge2].hull_edge = true;
                     break;
                 }
 
                 crossed_edge = face_edge;
-                face_edge = crossed_edge->twin->next;
-                new_vertex = new_vertex2;
+                face_edge = next(twin(crossed_edge));
+                new_vertex_id = new_vertex2;
                 part_edge1 = new_part_edge1;
                 part_edge2 = new_part_edge2;
-
             } while (true);
+
+            relabel_faces(first_edge);
         }
 
-        void get_intersected_edges(const line & new_line, std::vector<std::shared_ptr<edge>> & out) const
+        // Arrangement of all the lines at once, replaces the DCEL (at least two lines are needed).
+        // The crossings along every line are sorted first, by their rounded position and then exactly,
+        // then every vertex links its four edges and the infinite vertex links the rays in angular order.
+        // Both steps run on `threads` threads (0 means one per core).
+        // Parallel or concurrent lines are left to add_line.
+        void build(const std::vector<line> & input_lines, size_t threads = 0)
         {
-            std::shared_ptr<edge> inf_face_edge;
-            auto e = inf_node->e;
-            auto el = e->line_link;
-            auto l = std::make_shared<line>(new_line);
+            const std::vector<line> & in = input_lines;
+            uint32_t n = in.size();
+            *this = DCEL();
+            all_lines = in;
+            if (n < 2) {
+                return;
+            }
 
-            if (orientation_2d(-el->b, el->a, -l->b, l->a) != POS_DEAD) {
+            // order[i * (n - 1) + k]: line of the k-th crossing along line i,
+            // position[i * n + j]: index of the crossing with line j along line i
+            std::vector<uint32_t> order(size_t(n) * (n - 1)), position(size_t(n) * n);
+            std::vector<char> degenerate(n);
+
+            common::parallel_for(n, 16, [&](size_t first, size_t last) {
+                std::vector<std::pair<double, uint32_t>> keys;
+                for (uint32_t i = first; i != last; i++) {
+                    const line & l = in[i];
+                    keys.clear();
+                    for (uint32_t j = 0; j < n && !degenerate[i]; j++) {
+                        if (j == i) continue;
+                        degenerate[i] = (orientation_2d(l.a, l.b, in[j].a, in[j].b) == ZERO_DEAD);
+                        point_2 p = intersection_point<double>(l, in[j]);
+                        keys.push_back(std::make_pair(-l.b * p.x + l.a * p.y, j));
+                    }
+                    if (degenerate[i]) continue;
+                    std::sort(keys.begin(), keys.end());
+
+                    uint32_t * o = &order[size_t(i) * (n - 1)];
+                    for (uint32_t k = 0; k + 1 < n; k++) {
+                        o[k] = keys[k].second;
+                        for (uint32_t m = k; m > 0 && crossing_before(in, i, o[m], o[m - 1]); m--) {
+                            std::swap(o[m], o[m - 1]);
+                        }
+                    }
+                    for (uint32_t k = 0; k + 1 < n; k++) {
+                        position[size_t(i) * n + o[k]] = k;
+                        if (k > 0 && !crossing_before(in, i, o[k - 1], o[k])) {
+                            degenerate[i] = 1;
+                        }
+                    }
+                }
+            }, threads);
+
+            if (std::find(degenerate.begin(), degenerate.end(), 1) != degenerate.end()) {
+                *this = DCEL(in[0], in[1]);
+                for (uint32_t i = 2; i < n; i++) {
+                    add_line(in[i]);
+                }
+                return;
+            }
+
+            // line i is cut into n pieces, piece k has edges 2 (n i + k) along the line and 2 (n i + k) + 1 back,
+            // rays are linked to the line pointing away from their finite vertex
+            for (uint32_t i = 0; i < n; i++) {
+                new_line(in[i]);
+                reversed_line(2 * i);
+            }
+            vertices.resize(1 + size_t(n) * (n - 1) / 2);
+            crossings.resize(vertices.size());
+            edges.resize(2 * size_t(n) * n);
+            inf_node = 0;
+
+            common::parallel_for(n, 16, [&](size_t first, size_t last) {
+                for (uint32_t i = first; i != last; i++) {
+                    const uint32_t * o = &order[size_t(i) * (n - 1)];
+                    for (uint32_t k = 0; k < n; k++) {
+                        uint32_t e = 2 * (n * i + k);
+                        edges[e].twin = e + 1;
+                        edges[e + 1].twin = e;
+                        edges[e].origin = (k == 0 ? inf_node : crossing_vertex(i, o[k - 1]));
+                        edges[e + 1].origin = (k + 1 == n ? inf_node : crossing_vertex(i, o[k]));
+                        edges[e].line_link = edges[e + 1].line_link = (k == 0 ? 2 * i + 1 : 2 * i);
+                    }
+                }
+            }, threads);
+
+            // around a vertex the edge after an incoming one is the next outgoing clockwise from its twin
+            common::parallel_for(n, 16, [&](size_t first, size_t last) {
+                for (uint32_t i = first; i != last; i++) {
+                    const uint32_t * o = &order[size_t(i) * (n - 1)];
+                    for (uint32_t k = 0; k + 1 < n; k++) {
+                        uint32_t j = o[k];
+                        if (j < i) continue;
+
+                        uint32_t pj = position[size_t(j) * n + i];
+                        uint32_t out[4] = {2 * (n * i + k + 1), 2 * (n * j + pj + 1), 2 * (n * i + k) + 1, 2 * (n * j + pj) + 1};
+                        if (orientation_2d(in[i].a, in[i].b, in[j].a, in[j].b) == NEG_DEAD) {
+                            std::swap(out[1], out[3]);
+                        }
+
+                        uint32_t v = crossing_vertex(i, j);
+                        vertices[v] = vertex(2 * i, 2 * j);
+                        crossings[v] = line_cross(lines[2 * i], lines[2 * j]);
+                        vertices[v].e = out[0];
+                        for (int r = 0; r < 4; r++) {
+                            uint32_t in_edge = out[r] ^ 1, out_edge = out[(r + 3) % 4];
+                            edges[in_edge].next = out_edge;
+                            edges[out_edge].prev = in_edge;
+                        }
+                    }
+                }
+            }, threads);
+
+            // at the infinite vertex the rays go counterclockwise
+            std::vector<uint32_t> rays;
+            for (uint32_t i = 0; i < n; i++) {
+                rays.push_back(2 * n * i);
+                rays.push_back(2 * (n * i + n - 1) + 1);
+            }
+            std::sort(rays.begin(), rays.end(), [this](uint32_t e, uint32_t f) {
+                const line & l = edge_line(e), & m = edge_line(f);
+                bool e_upper = l.a > 0 || (l.a == 0 && l.b < 0), f_upper = m.a > 0 || (m.a == 0 && m.b < 0);
+                if (e_upper != f_upper) {
+                    return e_upper;
+                }
+                return orientation_2d(l.a, l.b, m.a, m.b) == POS_DEAD;
+            });
+
+            uint32_t first_ray = no_index;
+            for (size_t k = 0; k < rays.size(); k++) {
+                uint32_t in_edge = rays[k] ^ 1, out_edge = rays[(k + 1) % rays.size()];
+                edges[in_edge].next = out_edge;
+                edges[out_edge].prev = in_edge;
+
+                // add_line starts from the most clockwise of the rays pointing right
+                const line & l = edge_line(rays[k]);
+                if (is_direct_vector_right(l) && (first_ray == no_index ||
+                    orientation_2d(l.a, l.b, edge_line(first_ray).a, edge_line(first_ray).b) == POS_DEAD))
+                {
+                    first_ray = rays[k];
+                }
+            }
+            vertices[inf_node].e = first_ray;
+
+            label_faces(threads);
+        }
+
+        void get_intersected_edges(const line & new_line, std::vector<uint32_t> & out) const
+        {
+            uint32_t inf_face_edge;
+            uint32_t e = vertices[inf_node].e;
+            const line & l = new_line;
+
+            if (orientation_2d(-edge_line(e).b, edge_line(e).a, -l.b, l.a) != POS_DEAD) {
                 inf_face_edge = e;
             } else {
-                auto f = e->twin->next;
-                auto fl = f->line_link;
+                uint32_t f = next(twin(e));
 
                 while (true) {
-                    dead_sign e_or = orientation_2d(-el->b, el->a, -l->b, l->a);
-                    dead_sign f_or = orientation_2d(-fl->b, fl->a, -l->b, l->a);
+                    dead_sign e_or = orientation_2d(-edge_line(e).b, edge_line(e).a, -l.b, l.a);
+                    dead_sign f_or = orientation_2d(-edge_line(f).b, edge_line(f).a, -l.b, l.a);
                     if (e_or == ZERO_DEAD || (e_or != f_or && f_or != ZERO_DEAD)) break;
                     e = f;
-                    f = f->twin->next;
-                    el = e->line_link;
-                    fl = f->line_link;
+                    f = next(twin(f));
                 }
 
                 inf_face_edge = f;
             }
 
-            auto crossed_edge = inf_face_edge;
+            uint32_t crossed_edge = inf_face_edge;
             while (!edge_intersects_line(new_line, crossed_edge)) {
-                crossed_edge = crossed_edge->next;
+                crossed_edge = next(crossed_edge);
             }
             out.push_back(crossed_edge);
 
-            auto face_edge = crossed_edge->twin->next;
+            uint32_t face_edge = next(twin(crossed_edge));
             do {
-                while (face_edge->id != crossed_edge->twin->id && !edge_intersects_line(new_line, face_edge)) {
-                    face_edge = face_edge->next;
+                while (face_edge != twin(crossed_edge) && !edge_intersects_line(new_line, face_edge)) {
+                    face_edge = next(face_edge);
                 }
                 out.push_back(face_edge);
 
-                if (face_edge->id == crossed_edge->twin->id) { // end in last half plane
+                if (face_edge == twin(crossed_edge)) { // end in last half plane
                     break;
                 }
 
-                face_edge = face_edge->twin->next;
+                face_edge = next(twin(face_edge));
             } while (true);
         }
 
-        orientation_t point2edge_orientation(const std::shared_ptr<edge> & e, const point_2 & c) const
+        orientation_t point2edge_orientation(uint32_t e, const point_2 & c) const
         {
             if (is_ray(e)) {
-                int res = line_position(*e->line_link, c);
-                auto v = e->origin;
+                int res = line_position(edge_line(e), c);
+                bool right = is_direct_vector_right(edge_line(e));
                 if (res > 0) {
-                    return (!v->line1
-                            ? (is_direct_vector_right(*e->line_link) ? CG_RIGHT : CG_LEFT)
-                            : (is_direct_vector_right(*e->line_link) ? CG_LEFT : CG_RIGHT));
+                    return (is_inf(origin(e)) ? (right ? CG_RIGHT : CG_LEFT) : (right ? CG_LEFT : CG_RIGHT));
                 } else {
-                    return (!v->line1
-                            ? (is_direct_vector_right(*e->line_link) ? CG_LEFT : CG_RIGHT)
-                            : (is_direct_vector_right(*e->line_link) ? CG_RIGHT : CG_LEFT));
+                    return (is_inf(origin(e)) ? (right ? CG_LEFT : CG_RIGHT) : (right ? CG_RIGHT : CG_LEFT));
                 }
             }
 
-            auto v = e->origin;
-            auto u = e->next->origin;
-            return point_segment_orientation(*v->line1, *v->line2, *u->line1, *u->line2, c);
+            return orientation(crossings[origin(e)], crossings[origin(next(e))], line_cross(c));
         }
 
+        // half-edge of the face containing p
+        uint32_t get_face_by_point(const point_2 & p) const
+        {
+            uint32_t f = locate(p);
+            return f == no_index ? no_index : faces[f].e;
+        }
 
-        std::shared_ptr<edge> get_face_by_point(const point_2 & p)
+        // Face containing p. The walk starts from the hint face or, without a hint, from the sampled face
+        // with the bounding box nearest to p, and crosses an edge with p on its right until there is none.
+        // Faces are convex and a line is never crossed away from p, so the walk crosses
+        // each line separating the start face from p once.
+        uint32_t locate(const point_2 & p, uint32_t hint = no_index) const
         {
-            std::queue<std::shared_ptr<edge>> q;
-            q.push(inf_node->e);
-            std::vector<int> visited(max_edges);
-            visited[inf_node->e->id] = 1;
+            if (faces.empty()) {
+                return no_index;
+            }
 
-            while (!q.empty()) {
-                auto e = q.front();
-                q.pop();
+            uint32_t f = (hint < faces.size() ? hint : jump(p));
+            if (edges[faces[f].e].hull_edge) { // outer face of the bounding triangle
+                f = edges[twin(faces[f].e)].face;
+            }
 
-                if (visited[e->id] == 2) continue;
-                visited[e->id] = 2;
+            while (true) {
+                uint32_t e = faces[f].e;
+                while (point2edge_orientation(e, p) != CG_RIGHT) {
+                    e = next(e);
+                    if (e == faces[f].e) {
+                        return f;
+                    }
+                }
 
-                auto en = e;
-                bool all_same = true;
+                f = edges[twin(e)].face;
+                if (edges[twin(e)].hull_edge) {
+                    return f;
+                }
+            }
+        }
+
+        // start face for locate: among about sqrt(faces) evenly spread faces the one with the box nearest to p
+        uint32_t jump(const point_2 & p) const
+        {
+            size_t step = 1;
+            while (step * step < faces.size()) {
+                step++;
+            }
+
+            uint32_t best = 0;
+            double best_dist = std::numeric_limits<double>::max();
+            for (size_t f = 0; f < faces.size(); f += step) {
+                const rectangle_2 & box = faces[f].bbox;
+                if (box == rectangle_2::maximal()) continue;
+
+                double dx = std::max(std::max(box.x.inf - p.x, p.x - box.x.sup), 0.);
+                double dy = std::max(std::max(box.y.inf - p.y, p.y - box.y.sup), 0.);
+                if (dx * dx + dy * dy < best_dist) {
+                    best_dist = dx * dx + dy * dy;
+                    best = f;
+                }
+            }
+            return best;
+        }
+
+    private:
+        // vertex of lines i and j in build
+        static uint32_t crossing_vertex(uint32_t i, uint32_t j)
+        {
+            if (i > j) {
+                std::swap(i, j);
+            }
+            return 1 + j * (j - 1) / 2 + i;
+        }
+
+        // crossing of lines i and j comes before the crossing of i and k along i
+        static bool crossing_before(const std::vector<line> & lines, uint32_t i, uint32_t j, uint32_t k)
+        {
+            // line k grows along i when the determinant is positive, the first crossing is where it is negative
+            return line_point_sign(lines[k], lines[i], lines[j]) * orientation_2d(lines[i].a, lines[i].b, lines[k].a, lines[k].b) < 0;
+        }
+
+        // gives every face loop of the initial structure its own face,
+        // the vertex points for the boxes are computed on `threads` threads
+        void label_faces(size_t threads = 1)
+        {
+            std::vector<point_2> points(vertices.size());
+            common::parallel_for(vertices.size(), 4096, [&](size_t first, size_t last) {
+                for (size_t v = first; v != last; v++) {
+                    if (!is_inf(v)) {
+                        points[v] = vertex_point(v);
+                    }
+                }
+            }, threads);
+
+            // Euler's formula for the connected planar graph
+            faces.reserve(edges.size() / 2 + 2 - std::min(vertices.size(), edges.size() / 2 + 2));
+            for (uint32_t e = 0; e < edges.size(); e++) {
+                if (edges[e].face != no_index) continue;
+                faces.push_back(face());
+                set_face(e, faces.size() - 1, points.data());
+            }
+        }
+
+        // Edges from first_edge on were created by the last split; every face loop through them
+        // takes over the face of one of its old edges, or a new face when that face is already taken.
+        void relabel_faces(uint32_t first_edge)
+        {
+            std::vector<uint32_t> & taken = face_marks;
+            taken.resize(faces.size());
+            ++face_stamp;
+
+            for (uint32_t e = first_edge; e < edges.size(); e++) {
+                if (edges[e].face != no_index) continue;
+
+                uint32_t f = no_index, g = e;
                 do {
-                    visited[en->id] = 2;
-                    all_same &= (CG_RIGHT != point2edge_orientation(en, p));
-                    if (visited[en->twin->id] == 0) {
-                        visited[en->twin->id] = 1;
-                        q.push(en->twin);
+                    uint32_t old = edges[g].face;
+                    if (g < first_edge && old != no_index && taken[old] != face_stamp) {
+                        f = old;
+                        break;
                     }
-                    en = en->next;
-                } while (en->id != e->id);
+                    g = next(g);
+                } while (g != e);
 
-                if (all_same) {
-                    return e;
+                if (f == no_index) {
+                    f = faces.size();
+                    faces.push_back(face());
+                    taken.push_back(0);
                 }
+                taken[f] = face_stamp;
+                set_face(e, f);
             }
+        }
+
+        // labels the loop of e with f and recomputes the box of f,
+        // vertex coordinates are taken from points when they are given
+        void set_face(uint32_t e, uint32_t f, const point_2 * points = nullptr)
+        {
+            faces[f].e = e;
+            rectangle_2 & box = faces[f].bbox;
+            box = rectangle_2(range(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()),
+                              range(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()));
+            bool bounded = true;
 
-            return std::shared_ptr<edge>();
+            uint32_t g = e;
+            do {
+                edges[g].face = f;
+                if (is_inf(origin(g))) {
+                    bounded = false;
+                } else {
+                    point_2 v = (points ? points[origin(g)] : vertex_point(origin(g)));
+                    box.x = range(std::min(box.x.inf, v.x), std::max(box.x.sup, v.x));
+                    box.y = range(std::min(box.y.inf, v.y), std::max(box.y.sup, v.y));
+                }
+                g = next(g);
+            } while (g != e);
+
+            if (!bounded) {
+                box = rectangle_2::maximal();
+            }
         }
+
+        std::vector<uint32_t> face_marks;
+        uint32_t face_stamp = 0;
     };
 }
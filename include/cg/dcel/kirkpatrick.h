@@ -1,140 +1,292 @@
+#pragma once
+
 #include <cg/dcel/dcel.h>
+#include <cg/dcel/point_locator.h>
 
+#include <cmath>
+#include <limits>
 #include <set>
 
 namespace cg {
 
+    struct node_triangle
+    {
+        triangle_k t;
+        uint32_t node_edge;             // edge of the level the triangle was created in
+        std::vector<uint32_t> children; // indices in kirkpatrick_localization::nodes
+        bool is_leaf;
+        int depth;
+
+        node_triangle() {}
+
+        node_triangle(const triangle_k & t)
+            : t(t), node_edge(no_index), is_leaf(false), depth(0)
+        {}
+    };
+
+    // Read-only copy of the search DAG for queries. The children of a node take a contiguous range of slots
+    // and every slot keeps the corners of the child triangle rounded to double, with a bound of the error
+    // the rounding brings into each edge test, so the containment tests for all children of a node run
+    // as one flat loop.
+    // The tests the bounds cannot decide are repeated with the exact predicate on the node triangle.
+    struct frozen_dag
+    {
+        std::vector<uint32_t> first_slot; // slots of node v are [first_slot[v], first_slot[v + 1]), node `top` holds the root
+        std::vector<uint32_t> slot_node;
+        std::vector<double> x[3], y[3];
+        std::vector<double> bound0[3], bound1[3]; // edge k of a slot is off by at most bound0 + bound1 * (|p.x| + |p.y|)
+        std::vector<uint32_t> leaf_edge;  // node_edge of the leaves, no_index for the inner nodes
+        uint32_t top;
+
+        frozen_dag()
+            : top(no_index)
+        {}
+
+        frozen_dag(const std::vector<node_triangle> & nodes, uint32_t root)
+            : top(nodes.size())
+        {
+            first_slot.push_back(0);
+            for (const node_triangle & node : nodes) {
+                for (uint32_t child : node.children) {
+                    add_slot(nodes, child);
+                }
+                first_slot.push_back(slot_node.size());
+                leaf_edge.push_back(node.is_leaf ? node.node_edge : no_index);
+            }
+            if (root != no_index) {
+                add_slot(nodes, root);
+            }
+            first_slot.push_back(slot_node.size());
+        }
+
+        // same as descending nodes from the root to the first child containing p
+        uint32_t locate(const point_2 & p, const std::vector<node_triangle> & nodes) const
+        {
+            uint32_t v = top;
+            while (v != no_index) {
+                uint32_t c = child(v, p, nodes);
+                if (c == no_index || leaf_edge[c] != no_index) {
+                    return c == no_index ? no_index : leaf_edge[c];
+                }
+                v = c;
+            }
+            return no_index;
+        }
+
+    private:
+        // first child of v containing p, no_index if there is none
+        uint32_t child(uint32_t v, const point_2 & p, const std::vector<node_triangle> & nodes) const
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            const uint32_t block = 16;
+            int state[block];
+            const double * cx[3] = {x[0].data(), x[1].data(), x[2].data()};
+            const double * cy[3] = {y[0].data(), y[1].data(), y[2].data()};
+            const double * b0[3] = {bound0[0].data(), bound0[1].data(), bound0[2].data()};
+            const double * b1[3] = {bound1[0].data(), bound1[1].data(), bound1[2].data()};
+            const double rx = p.x, ry = p.y, rn = fabs(p.x) + fabs(p.y);
+
+            for (uint32_t first = first_slot[v]; first < first_slot[v + 1]; first += block) {
+                uint32_t m = std::min(block, first_slot[v + 1] - first);
+
+                // 1 inside, -1 outside, 0 undecided
+                for (uint32_t l = 0; l < m; l++) {
+                    uint32_t s = first + l;
+                    int in = 1, out = 0;
+                    for (int k = 0; k < 3; k++) {
+                        int k1 = (k == 2 ? 0 : k + 1);
+                        double px = cx[k][s], py = cy[k][s];
+                        double left = (cx[k1][s] - px) * (ry - py), right = (cy[k1][s] - py) * (rx - px);
+                        double bound = b0[k][s] + b1[k][s] * rn + 8 * eps * (fabs(left) + fabs(right));
+                        in &= int(left - right > bound);
+                        out |= int(left - right < -bound);
+                    }
+                    state[l] = in - out;
+                }
+
+                for (uint32_t l = 0; l < m; l++) {
+                    uint32_t c = slot_node[first + l];
+                    if (state[l] > 0) {
+                        return c;
+                    }
+                    if (state[l] == 0 && triangle_contains_convex_point(nodes[c].t, line_cross(p))) {
+                        return c;
+                    }
+                }
+            }
+            return no_index;
+        }
+
+        void add_slot(const std::vector<node_triangle> & nodes, uint32_t child)
+        {
+            slot_node.push_back(child);
+            point_2 c[3];
+            double e[3];
+            for (int k = 0; k < 3; k++) {
+                c[k] = nodes[child].t[k].point();
+                e[k] = corner_error(nodes[child].t[k], c[k]);
+                x[k].push_back(c[k].x);
+                y[k].push_back(c[k].y);
+            }
+
+            // moving the corners by e changes (q - p) x (r - p) by at most
+            // e_p |q - r| + e_q |p - r| + 2 e_p e_q, with |q - r| <= |q| + |r| in the l1 norm
+            for (int k = 0; k < 3; k++) {
+                int k1 = (k + 1) % 3;
+                double b0 = 1.01 * (e[k] * (fabs(c[k1].x) + fabs(c[k1].y)) + e[k1] * (fabs(c[k].x) + fabs(c[k].y))
+                                    + 2 * e[k] * e[k1]);
+                double b1 = 1.01 * (e[k] + e[k1]);
+                bound0[k].push_back(std::isfinite(b0) ? b0 : std::numeric_limits<double>::infinity());
+                bound1[k].push_back(std::isfinite(b1) ? b1 : std::numeric_limits<double>::infinity());
+            }
+        }
+
+        // bound of the error of the corner c = p.point(), infinite when it can not be trusted
+        static double corner_error(const line_cross & p, const point_2 & c)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            double det = fabs(p.w);
+            if (!(det > 4 * p.ew)) {
+                return std::numeric_limits<double>::infinity();
+            }
+
+            double rel = p.ew / det + eps;
+            double ex = p.ex / det + fabs(c.x) * rel;
+            double ey = p.ey / det + fabs(c.y) * rel;
+            double res = 2 * std::max(ex, ey);
+            return std::isfinite(res) ? res : std::numeric_limits<double>::infinity();
+        }
+    };
+
     struct triangulation_level
     {
         DCEL dcel;
-        std::vector< std::vector<std::shared_ptr<vertex>> > graph;
-        std::vector< std::shared_ptr<vertex> > vertices;
+        std::vector< std::vector<uint32_t> > graph;
+        std::vector<char> reachable; // vertices still in the level
 
         triangulation_level() {}
 
-        triangulation_level(const DCEL & other_dcel, bool need_to_build_triangles) // building initial triangulation
+        // with need_to_build_triangles every face of the DCEL is triangulated and gets its leaf in nodes
+        triangulation_level(const DCEL & other_dcel, bool need_to_build_triangles, std::vector<node_triangle> & nodes)
             : dcel(other_dcel)
         {
             if (!need_to_build_triangles) return;
 
-            std::queue<std::shared_ptr<vertex>> q;
-            std::vector<bool> binded(dcel.max_edges);
-            std::vector<int> visited(dcel.max_vertex);
+            std::queue<uint32_t> q;
+            std::vector<char> binded(dcel.edges.size()); // grows with the triangle edges
+            std::vector<int> visited(dcel.vertices.size());
             q.push(dcel.inf_node);
-            visited[dcel.inf_node->id] = 1;
+            visited[dcel.inf_node] = 1;
 
             while (!q.empty()) {
-                std::shared_ptr<vertex> v = q.front();
+                uint32_t v = q.front();
                 q.pop();
 
-                std::shared_ptr<edge> e = v->e;
+                uint32_t e = dcel.vertices[v].e;
                 do {
-                    if (e->hull_edge || e->triangle_edge || binded[e->id]) {
-                        binded[e->id] = true;
-                        e = e->twin->next;
+                    if (dcel.edges[e].hull_edge || dcel.edges[e].triangle_edge || binded[e]) {
+                        binded[e] = true;
+                        e = dcel.next(dcel.twin(e));
                         continue;
                     }
-                    binded[e->id] = true;
+                    binded[e] = true;
 
-                    auto last_edge = e;
-                    auto f = e->next;
+                    uint32_t last_edge = e;
+                    uint32_t f = dcel.next(e);
                     do {
-                        binded[f->id] = true;
+                        binded[f] = true;
 
-                        if (!visited[f->origin->id]) {
-                            visited[f->origin->id] = 1;
-                            q.push(f->origin);
+                        if (!visited[dcel.origin(f)]) {
+                            visited[dcel.origin(f)] = 1;
+                            q.push(dcel.origin(f));
                         }
 
-                        std::shared_ptr<triangle_k> t = std::make_shared<triangle_k>(
-                            line_cross(v->line1, v->line2),
-                            line_cross(f->origin->line1, f->origin->line2),
-                            line_cross(f->next->origin->line1, f->next->origin->line2)
-                        );
+                        node_triangle node(dcel.triangle(v, dcel.origin(f), dcel.origin(dcel.next(f))));
+                        node.node_edge = f;
+                        node.is_leaf = true;
+                        dcel.edges[f].triangle_link = nodes.size();
+                        nodes.push_back(node);
 
-                        f->triangle_link = std::make_shared<node_triangle>(t);
-                        f->triangle_link->node_edge = f;
-                        f->triangle_link->is_leaf = true;
-                        f->triangle_link->depth = 0;
-
-                        // join v and f->origin with triangle edge
-                        auto next_f = f->next;
-                        if (next_f->next->origin->id == v->id) {
+                        // join v and f origin with triangle edge
+                        uint32_t next_f = dcel.next(f);
+                        if (dcel.origin(dcel.next(next_f)) == v) {
                             f = next_f;
                             break;
                         }
 
-                        std::shared_ptr<edge> tedge1 = std::make_shared<edge>(dcel.max_edges);
-                        std::shared_ptr<edge> tedge2 = std::make_shared<edge>(dcel.max_edges);
-
-                        tedge1->origin = v;
-                        tedge1->twin = tedge2;
-                        tedge1->next = next_f;
-                        tedge1->prev = last_edge->prev;
-                        tedge1->triangle_edge = true;
-
-                        tedge2->origin = next_f->origin;
-                        tedge2->twin = tedge1;
-                        tedge2->next = last_edge;
-                        tedge2->prev = f;
-                        tedge2->triangle_edge = true;
-
-                        last_edge->prev->next = tedge1;
-                        last_edge->prev = tedge2;
-                        f->next = tedge2;
-                        next_f->prev = tedge1;
+                        uint32_t tedge1 = dcel.new_edge();
+                        uint32_t tedge2 = dcel.new_edge();
+                        binded.resize(dcel.edges.size());
+
+                        edge & t1 = dcel.edges[tedge1];
+                        t1.origin = v;
+                        t1.twin = tedge2;
+                        t1.next = next_f;
+                        t1.prev = dcel.prev(last_edge);
+                        t1.triangle_edge = true;
+
+                        edge & t2 = dcel.edges[tedge2];
+                        t2.origin = dcel.origin(next_f);
+                        t2.twin = tedge1;
+                        t2.next = last_edge;
+                        t2.prev = f;
+                        t2.triangle_edge = true;
+
+                        dcel.edges[dcel.prev(last_edge)].next = tedge1;
+                        dcel.edges[last_edge].prev = tedge2;
+                        dcel.edges[f].next = tedge2;
+                        dcel.edges[next_f].prev = tedge1;
 
                         last_edge = tedge1;
                         f = next_f;
-                    } while (f->next->origin->id != v->id);
+                    } while (dcel.origin(dcel.next(f)) != v);
 
-                    binded[f->id] = true;
+                    binded[f] = true;
 
-                    if (!visited[f->origin->id]) {
-                        visited[f->origin->id] = 1;
-                        q.push(f->origin);
+                    if (!visited[dcel.origin(f)]) {
+                        visited[dcel.origin(f)] = 1;
+                        q.push(dcel.origin(f));
                     }
 
-                    e = e->twin->next;
-                } while (e->id != v->e->id);
+                    e = dcel.next(dcel.twin(e));
+                } while (e != dcel.vertices[v].e);
             }
         }
 
         void create_graph()
         {
             graph.clear();
-            vertices.clear();
-            graph.resize(dcel.max_vertex);
-            vertices.resize(dcel.max_vertex);
+            reachable.clear();
+            graph.resize(dcel.vertices.size());
+            reachable.resize(dcel.vertices.size());
 
-            std::queue<std::shared_ptr<vertex>> que;
-            std::vector<int> visited(dcel.max_vertex);
-            visited[dcel.inf_node->id] = 1;
+            std::queue<uint32_t> que;
+            std::vector<int> visited(dcel.vertices.size());
+            visited[dcel.inf_node] = 1;
             que.push(dcel.inf_node);
-            vertices[0] = dcel.inf_node;
+            reachable[dcel.inf_node] = 1;
 
             while (!que.empty()) {
-                auto v = que.front();
-                std::set<int> out_vertices;
+                uint32_t v = que.front();
+                std::set<uint32_t> out_vertices;
                 que.pop();
 
-                std::shared_ptr<edge> e = v->e;
+                uint32_t e = dcel.vertices[v].e;
                 do {
-                    if (out_vertices.count(e->next->origin->id) == 0 &&
-                        e->next->origin->id != v->id)
-                    {
-                        graph[v->id].push_back(e->next->origin);
-                        out_vertices.insert(e->next->origin->id);
+                    uint32_t u = dcel.origin(dcel.next(e));
+                    if (out_vertices.count(u) == 0 && u != v) {
+                        graph[v].push_back(u);
+                        out_vertices.insert(u);
                     }
 
-                    if (!visited[e->next->origin->id]) {
-                        visited[e->next->origin->id] = 1;
-                        que.push(e->next->origin);
-                        vertices[e->next->origin->id] = e->next->origin;
+                    if (!visited[u]) {
+                        visited[u] = 1;
+                        que.push(u);
+                        reachable[u] = 1;
                     }
 
-                    e = e->twin->next;
-                } while (e->id != v->e->id);
+                    e = dcel.next(dcel.twin(e));
+                } while (e != dcel.vertices[v].e);
             }
         }
     };
@@ -144,17 +296,24 @@ namespace cg {
         DCEL dcel;
         DCEL hulled_dcel;
         std::vector<triangulation_level> levels;
-        std::shared_ptr<node_triangle> root;
+        std::vector<node_triangle> nodes; // the search DAG, leaves are the triangles of levels[0]
+        uint32_t root;
+        frozen_dag frozen; // query copy of nodes
         int max_depth;
+        std::vector<uint32_t> face_hint; // face of dcel around each face of hulled_dcel
+        size_t built_lines;              // lines of dcel when the hierarchy was last built
+        double rebuild_factor;           // append_line rebuilds once the newer lines exceed this part of built_lines
 
-        kirkpatrick_localization() {}
+        kirkpatrick_localization()
+            : root(no_index), built_lines(0), rebuild_factor(0.5)
+        {}
 
         kirkpatrick_localization(const line & line1, const line & line2)
-            : dcel(line1, line2)
+            : dcel(line1, line2), root(no_index), built_lines(0), rebuild_factor(0.5)
         {}
 
         kirkpatrick_localization(const kirkpatrick_localization & other)
-            : dcel(other.dcel)
+            : dcel(other.dcel), root(no_index), built_lines(0), rebuild_factor(other.rebuild_factor)
         {}
 
         void add_line(const line & l)
@@ -162,229 +321,292 @@ namespace cg {
             dcel.add_line(l);
         }
 
-        std::shared_ptr<edge> naive_localization(const point_2 & p)
+        // add_line for a stream of lines: the hierarchy is only rebuilt when it lags too far behind,
+        // so each line pays O(1) amortized rebuilds of a structure at most 1 + rebuild_factor times larger
+        void append_line(const line & l)
+        {
+            dcel.add_line(l);
+            if (root == no_index || dcel.all_lines.size() - built_lines > rebuild_factor * built_lines) {
+                rebuild();
+            }
+        }
+
+        // face of dcel containing p. The hierarchy gives the face of the arrangement it was built from
+        // and the walk in dcel only crosses the lines added since; without a hierarchy the walk does it all
+        uint32_t locate(const point_2 & p) const
+        {
+            uint32_t e = fast_localization(p);
+            return dcel.locate(p, e == no_index ? no_index : face_hint[levels[0].dcel.edges[e].face]);
+        }
+
+        void rebuild()
+        {
+            std::vector<std::vector<uint32_t>> deleted_vertices;
+            build_triangulation(deleted_vertices);
+        }
+
+        // edge of dcel
+        uint32_t naive_localization(const point_2 & p) const
         {
             return dcel.get_face_by_point(p);
         }
 
-        std::shared_ptr<edge> fast_localization(const point_2 & p)
+        // edge of levels[0].dcel, no_index outside of the bounding triangle
+        uint32_t fast_localization(const point_2 & p) const
         {
-            line l1(1, 0, -p.x), l2(0, 1, -p.y);
-            if (!triangle_contains_convex_point(*root->t, l1, l2)) {
-                return nullptr;
-            }
+            return frozen.locate(p, nodes);
+        }
 
-            std::shared_ptr<node_triangle> node = root;
-            while (!node->is_leaf) {
-                for (auto child : node->children) {
-                    if (triangle_contains_convex_point(*child->t, l1, l2)) {
-                        node = child;
-                        break;
-                    }
+        // locate for points[0, count) into faces[0, count) on `threads` threads (0 means one per core)
+        void locate_batch(const point_2 * points, size_t count, uint32_t * faces, size_t threads = 0) const
+        {
+            common::parallel_for(count, 4096, [&](size_t first, size_t last) {
+                for (size_t i = first; i != last; i++) {
+                    faces[i] = locate(points[i]);
                 }
-            }
+            }, threads);
+        }
+
+        void locate_batch(const std::vector<point_2> & points, std::vector<uint32_t> & faces, size_t threads = 0) const
+        {
+            faces.resize(points.size());
+            locate_batch(points.data(), points.size(), faces.data(), threads);
+        }
 
-            return node->node_edge;;
+        void build_triangulation(std::vector<std::vector<uint32_t>> & deleted_vertices)
+        {
+            build_hierarchy(dcel.all_lines, deleted_vertices);
+            built_lines = dcel.all_lines.size();
+            fill_face_hint();
         }
 
-        void build_triangulation(std::vector<std::vector<std::shared_ptr<vertex>>> & deleted_vertices)
+        // hulled_dcel of the lines and the hierarchy over it, leaves dcel and face_hint as they are
+        void build_hierarchy(const std::vector<line> & lines, std::vector<std::vector<uint32_t>> & deleted_vertices)
         {
             deleted_vertices.clear();
             levels.clear();
+            nodes.clear();
+            root = no_index;
 
-            hulled_dcel = DCEL(dcel.all_lines);
-            levels.push_back(triangulation_level(hulled_dcel, true));
+            hulled_dcel = DCEL(lines);
+            levels.push_back(triangulation_level(hulled_dcel, true, nodes));
 
             max_depth = 0;
-            deleted_vertices.push_back(std::vector<std::shared_ptr<vertex>>());
+            deleted_vertices.push_back(std::vector<uint32_t>());
             while (not_trivial_dcel(levels.back().dcel)) {
                 max_depth++;
                 levels.push_back(compress_level(levels.back(), deleted_vertices.back()));
-                deleted_vertices.push_back(std::vector<std::shared_ptr<vertex>>());
+                deleted_vertices.push_back(std::vector<uint32_t>());
             }
+
+            frozen = frozen_dag(nodes, root);
         }
 
-        bool not_trivial_dcel(const DCEL & dcel)
+        // later lines split faces of dcel keeping one part under the old id,
+        // so the hint stays inside the face of the hulled arrangement
+        void fill_face_hint()
         {
-            std::queue<std::shared_ptr<vertex>> que;
-            std::vector<int> visited(dcel.max_vertex);
-            visited[dcel.inf_node->id] = 1;
+            face_hint.assign(hulled_dcel.faces.size(), no_index);
+            uint32_t f = no_index;
+            for (uint32_t h = 0; h < hulled_dcel.faces.size(); h++) {
+                double x = 0, y = 0;
+                int n = 0;
+                uint32_t e = hulled_dcel.faces[h].e;
+                do {
+                    point_2 v = hulled_dcel.vertex_point(hulled_dcel.origin(e));
+                    x += v.x;
+                    y += v.y;
+                    n++;
+                    e = hulled_dcel.next(e);
+                } while (e != hulled_dcel.faces[h].e);
+
+                f = dcel.locate(point_2(x / n, y / n), f);
+                face_hint[h] = f;
+            }
+        }
+
+        bool not_trivial_dcel(const DCEL & dcel) const
+        {
+            std::queue<uint32_t> que;
+            std::vector<int> visited(dcel.vertices.size());
+            visited[dcel.inf_node] = 1;
             que.push(dcel.inf_node);
             int size = 1;
 
             while (!que.empty()) {
-                auto v = que.front();
+                uint32_t v = que.front();
                 que.pop();
 
-                auto e = v->e;
+                uint32_t e = dcel.vertices[v].e;
                 do {
-                    if (!visited[e->next->origin->id]) {
-                        visited[e->next->origin->id] = 1;
-                        que.push(e->next->origin);
+                    uint32_t u = dcel.origin(dcel.next(e));
+                    if (!visited[u]) {
+                        visited[u] = 1;
+                        que.push(u);
                         size++;
                     }
 
                     if (size > 3) return true;
 
-                    e = e->twin->next;
-                } while (e->id != v->e->id);
+                    e = dcel.next(dcel.twin(e));
+                } while (e != dcel.vertices[v].e);
             }
 
             return size > 3;
         }
 
         triangulation_level compress_level(const triangulation_level & prev_level,
-                                           std::vector<std::shared_ptr<vertex>> & deleted_vertices)
+                                           std::vector<uint32_t> & deleted_vertices)
         {
-            triangulation_level new_level(prev_level.dcel, false);
+            triangulation_level new_level(prev_level.dcel, false, nodes);
             new_level.create_graph();
+            DCEL & d = new_level.dcel;
 
-            std::vector<int> marked(new_level.dcel.max_vertex);
+            std::vector<int> marked(d.vertices.size());
 
-            for (size_t i = 3; i < new_level.graph.size(); i++) { // ignore inf vertex, never delete it
-                if (new_level.vertices[i] && new_level.graph[i].size() < 12 && !marked[i]) {
-                    std::shared_ptr<vertex> del_v = new_level.vertices[i];
-                    std::shared_ptr<edge> face_edge = nullptr;
+            for (uint32_t i = 3; i < new_level.graph.size(); i++) { // ignore inf vertex, never delete it
+                if (new_level.reachable[i] && new_level.graph[i].size() < 12 && !marked[i]) {
+                    uint32_t del_v = i;
+                    uint32_t face_edge = no_index;
 
-                    std::vector<std::shared_ptr<node_triangle>> nodes;
+                    std::vector<uint32_t> old_nodes;
 
                     deleted_vertices.push_back(del_v);
 
-                    // delete vertex froc DCEL
-                    auto e = del_v->e;
+                    // delete vertex from DCEL
+                    uint32_t e = d.vertices[del_v].e;
                     do {
-                        if (e->hull_edge || e->twin->hull_edge) {
-                            e = e->twin->next;
+                        if (d.edges[e].hull_edge || d.edges[d.twin(e)].hull_edge) {
+                            e = d.next(d.twin(e));
                             continue;
                         }
 
-                        auto in_edge1 = e->twin->prev;
-                        auto in_edge2 = e->next;
-                        if (!face_edge) {
+                        uint32_t in_edge1 = d.prev(d.twin(e));
+                        uint32_t in_edge2 = d.next(e);
+                        if (face_edge == no_index) {
                             face_edge = in_edge2;
                         }
 
                         // get triangles of face
-                        std::shared_ptr<node_triangle> t1 = find_triangle(in_edge1);
-                        std::shared_ptr<node_triangle> t2 = find_triangle(in_edge2);
-                        if (t1) nodes.push_back(t1);
-                        if (t2) nodes.push_back(t2);
-
-                        in_edge2->prev = in_edge1;
-                        in_edge1->next = e->next;
-                        if (in_edge2->origin->e->id == e->twin->id) {
-                            in_edge2->origin->e = in_edge2;
+                        uint32_t t1 = find_triangle(d, in_edge1);
+                        uint32_t t2 = find_triangle(d, in_edge2);
+                        if (t1 != no_index) old_nodes.push_back(t1);
+                        if (t2 != no_index) old_nodes.push_back(t2);
+
+                        d.edges[in_edge2].prev = in_edge1;
+                        d.edges[in_edge1].next = d.next(e);
+                        if (d.vertices[d.origin(in_edge2)].e == d.twin(e)) {
+                            d.vertices[d.origin(in_edge2)].e = in_edge2;
                         }
 
-                        auto v = in_edge1->origin;
-                        auto u = in_edge2->origin;
-                        auto t = in_edge2->next->origin;
-                        if (precise_turn_predicate(*v->line1, *v->line2, *u->line1, *u->line2, *t->line1, *t->line2) == CG_COLLINEAR &&
-                            vertex_size(e->next->origin) <= 2 && e->next->origin->id != 0
-                            && in_edge1->id != in_edge2->twin->id)
+                        if (orientation(d.vertex_cross(d.origin(in_edge1)), d.vertex_cross(d.origin(in_edge2)),
+                                        d.vertex_cross(d.origin(d.next(in_edge2)))) == CG_COLLINEAR &&
+                            vertex_size(d, d.origin(d.next(e))) <= 2 && d.origin(d.next(e)) != 0
+                            && in_edge1 != d.twin(in_edge2))
                         {
-                            if (face_edge->id == in_edge2->id) {
+                            if (face_edge == in_edge2) {
                                 face_edge = in_edge1;
                             }
-                            merge_two_edges(in_edge1, in_edge2);
+                            merge_two_edges(d, in_edge1, in_edge2);
                         }
 
-                        e = e->twin->next;
-                    } while (e->id != del_v->e->id);
+                        e = d.next(d.twin(e));
+                    } while (e != d.vertices[del_v].e);
 
-                    if (e->hull_edge) {
-                        del_v->e->twin->next = del_v->e->prev->twin;
-                        del_v->e->prev->twin->prev = del_v->e->twin;
+                    uint32_t first = d.vertices[del_v].e;
+                    if (d.edges[e].hull_edge) {
+                        d.edges[d.twin(first)].next = d.twin(d.prev(first));
+                        d.edges[d.twin(d.prev(first))].prev = d.twin(first);
                     }
 
-                    if (e->hull_edge && vertex_size(del_v) == 2) {
-                        if (face_edge->id == e->prev->twin->id) {
-                            face_edge = e->twin;
+                    if (d.edges[e].hull_edge && vertex_size(d, del_v) == 2) {
+                        if (face_edge == d.twin(d.prev(e))) {
+                            face_edge = d.twin(e);
                         }
-                        merge_two_edges(e->prev, e);
+                        merge_two_edges(d, d.prev(e), e);
                     }
 
                     // retriangulate face
                     do {
-                        auto v = face_edge->origin;
-                        auto u = face_edge->next->origin;
-                        auto s = face_edge->next->next->origin;
-
-                        std::shared_ptr<triangle_k> triangle = std::make_shared<triangle_k>(
-                            line_cross(v->line1, v->line2),
-                            line_cross(u->line1, u->line2),
-                            line_cross(s->line1, s->line2)
-                        );
-                        std::shared_ptr<node_triangle> node = std::make_shared<node_triangle>(triangle);
-                        node->depth = max_depth;
-
-                        if (is_triangle_face(face_edge)) {
-                            face_edge->triangle_link = node;
-                            node->node_edge = face_edge;
-                            for (auto old_triangle : nodes) {
-                                if (triangle_intersection(*triangle, *old_triangle->t)) {
-                                    node->children.push_back(old_triangle);
+                        uint32_t v = d.origin(face_edge);
+                        uint32_t u = d.origin(d.next(face_edge));
+                        uint32_t s = d.origin(d.next(d.next(face_edge)));
+
+                        node_triangle node(d.triangle(v, u, s));
+                        node.depth = max_depth;
+
+                        if (is_triangle_face(d, face_edge)) {
+                            node.node_edge = face_edge;
+                            for (uint32_t old_triangle : old_nodes) {
+                                if (triangle_intersection(node.t, nodes[old_triangle].t)) {
+                                    node.children.push_back(old_triangle);
                                 }
                             }
 
-                            if (!not_trivial_dcel(new_level.dcel)) {
-                                root = node;
+                            d.edges[face_edge].triangle_link = nodes.size();
+                            if (!not_trivial_dcel(d)) {
+                                root = nodes.size();
                             }
+                            nodes.push_back(node);
 
                             break;
                         }
 
-                        bool is_ear = precise_turn_predicate(*v->line1, *v->line2, *u->line1, *u->line2, *s->line1, *s->line2) == CG_LEFT;
+                        bool is_ear = orientation(d.vertex_cross(v), d.vertex_cross(u), d.vertex_cross(s)) == CG_LEFT;
                         if (is_ear) {
-                            auto e = face_edge;
+                            uint32_t f = face_edge;
                             do {
-                                auto t = e->origin;
-                                if (t->id != v->id && t->id != u->id && t->id != s->id) {
-                                    is_ear = !triangle_contains_convex_point(*triangle, *t->line1, *t->line2);
+                                uint32_t t = d.origin(f);
+                                if (t != v && t != u && t != s) {
+                                    is_ear = !triangle_contains_convex_point(node.t, d.vertex_cross(t));
                                 }
-                                e = e->next;
-                            } while (is_ear && e->id != face_edge->id);
+                                f = d.next(f);
+                            } while (is_ear && f != face_edge);
                         }
 
-                        if (is_ear && !triangle_contains_star_point(*triangle, *del_v->line1, *del_v->line2)) {
+                        if (is_ear && !triangle_contains_star_point(node.t, d.vertex_cross(del_v))) {
                             // create new triangle edge
-                            std::shared_ptr<edge> tedge1 = std::make_shared<edge>(new_level.dcel.max_edges);
-                            std::shared_ptr<edge> tedge2 = std::make_shared<edge>(new_level.dcel.max_edges);
-
-                            tedge1->origin = v;
-                            tedge1->twin = tedge2;
-                            tedge1->next = face_edge->next->next;
-                            tedge1->prev = face_edge->prev;
-                            tedge1->triangle_edge = true;
-
-                            tedge2->origin = s;
-                            tedge2->twin = tedge1;
-                            tedge2->next = face_edge;
-                            tedge2->prev = face_edge->next;
-                            tedge2->triangle_edge = true;
-                            tedge2->triangle_link = node;
-
-                            face_edge->prev->next = tedge1;
-                            face_edge->prev = tedge2;
-                            face_edge->next->next->prev = tedge1;
-                            face_edge->next->next = tedge2;
-
-                            for (auto old_triangle : nodes) {
-                                if (triangle_intersection(*triangle, *old_triangle->t)) {
-                                    node->children.push_back(old_triangle);
+                            uint32_t tedge1 = d.new_edge();
+                            uint32_t tedge2 = d.new_edge();
+                            uint32_t node_id = nodes.size();
+
+                            edge & t1 = d.edges[tedge1];
+                            t1.origin = v;
+                            t1.twin = tedge2;
+                            t1.next = d.next(d.next(face_edge));
+                            t1.prev = d.prev(face_edge);
+                            t1.triangle_edge = true;
+
+                            edge & t2 = d.edges[tedge2];
+                            t2.origin = s;
+                            t2.twin = tedge1;
+                            t2.next = face_edge;
+                            t2.prev = d.next(face_edge);
+                            t2.triangle_edge = true;
+                            t2.triangle_link = node_id;
+
+                            d.edges[d.prev(face_edge)].next = tedge1;
+                            d.edges[face_edge].prev = tedge2;
+                            d.edges[d.next(d.next(face_edge))].prev = tedge1;
+                            d.edges[d.next(face_edge)].next = tedge2;
+
+                            for (uint32_t old_triangle : old_nodes) {
+                                if (triangle_intersection(node.t, nodes[old_triangle].t)) {
+                                    node.children.push_back(old_triangle);
                                 }
                             }
 
-                            node->node_edge = face_edge;
+                            node.node_edge = face_edge;
+                            nodes.push_back(node);
                             face_edge = tedge1;
                         } else {
-                            face_edge = face_edge->next;
+                            face_edge = d.next(face_edge);
                         }
                     } while (true);
 
                     // mark neighbour nodes as visited
-                    for (auto u : new_level.graph[i]) {
-                        marked[u->id] = 1;
+                    for (uint32_t u : new_level.graph[i]) {
+                        marked[u] = 1;
                     }
                 }
                 marked[i] = 1;
@@ -393,53 +615,88 @@ namespace cg {
             return new_level;
         }
 
-        int vertex_size(const std::shared_ptr<vertex> & v)
+        static int vertex_size(const DCEL & d, uint32_t v)
         {
             int size = 0;
-            auto e = v->e;
+            uint32_t e = d.vertices[v].e;
             do {
                 size++;
-                e = e->twin->next;
-            } while (e->id != v->e->id);
+                e = d.next(d.twin(e));
+            } while (e != d.vertices[v].e);
             return size;
         }
 
-        bool is_triangle_face(const std::shared_ptr<edge> & e)
+        static bool is_triangle_face(const DCEL & d, uint32_t e)
         {
-            auto f = e;
+            uint32_t f = e;
             int size = 0;
             do {
                 size++;
                 if (size > 3) return false;
-                f = f->next;
-            } while (f->id != e->id);
+                f = d.next(f);
+            } while (f != e);
             return size <= 3;
         }
 
-        void merge_two_edges(std::shared_ptr<edge> in_edge1, std::shared_ptr<edge> in_edge2)
+        static void merge_two_edges(DCEL & d, uint32_t in_edge1, uint32_t in_edge2)
         {
-            in_edge2->next->prev = in_edge1;
-            in_edge1->next = in_edge2->next;
-            in_edge1->twin->next->prev = in_edge2->twin;
-            in_edge2->twin->next = in_edge1->twin->next;
-            in_edge1->twin = in_edge2->twin;
-            in_edge2->twin->twin = in_edge1;
+            d.edges[d.next(in_edge2)].prev = in_edge1;
+            d.edges[in_edge1].next = d.next(in_edge2);
+            d.edges[d.next(d.twin(in_edge1))].prev = d.twin(in_edge2);
+            d.edges[d.twin(in_edge2)].next = d.next(d.twin(in_edge1));
+            d.edges[in_edge1].twin = d.twin(in_edge2);
+            d.edges[d.twin(in_edge2)].twin = in_edge1;
         }
 
-        std::shared_ptr<node_triangle> find_triangle(const std::shared_ptr<edge> & e)
+        // takes the triangle link off one of the three edges starting at e
+        static uint32_t find_triangle(DCEL & d, uint32_t e)
         {
-            auto f = e;
+            uint32_t f = e;
             for (int i = 0; i < 3; i++) {
-                if (!f->triangle_link) {
-                    f = f->next;
+                if (d.edges[f].triangle_link == no_index) {
+                    f = d.next(f);
                 } else {
-                    auto t = f->triangle_link;
-                    f->triangle_link = std::shared_ptr<node_triangle>();
+                    uint32_t t = d.edges[f].triangle_link;
+                    d.edges[f].triangle_link = no_index;
                     return t;
                 }
             }
 
-            return std::shared_ptr<node_triangle>();
+            return no_index;
+        }
+    };
+
+    // kirkpatrick_localization behind the point_locator interface
+    struct kirkpatrick_locator : point_locator
+    {
+        kirkpatrick_localization kl;
+
+        // only the hulled arrangement and the hierarchy are built, locate answers from them alone;
+        // fewer than two lines leave the bounding triangle only, located without a hierarchy
+        void build(const std::vector<line> & lines)
+        {
+            if (lines.size() < 2) {
+                kl.hulled_dcel = DCEL(lines);
+                kl.root = no_index;
+                return;
+            }
+            std::vector<std::vector<uint32_t>> deleted_vertices;
+            kl.build_hierarchy(lines, deleted_vertices);
+        }
+
+        // leaves keep an edge of the face they were cut from, edges[0] is on the outer face
+        uint32_t locate(const point_2 & p) const
+        {
+            if (kl.root == no_index) {
+                return kl.hulled_dcel.locate(p);
+            }
+            uint32_t e = kl.fast_localization(p);
+            return kl.levels[0].dcel.edges[e == no_index ? 0 : e].face;
+        }
+
+        const DCEL & arrangement() const
+        {
+            return kl.hulled_dcel;
         }
     };
 }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cg/dcel/dcel.h>
+
+namespace cg {
+
+    // Point location in the arrangement of lines clipped by its bounding triangle, that is DCEL(lines).
+    // Implementations are interchangeable: they build the same arrangement and answer with its face ids.
+    struct point_locator
+    {
+        virtual ~point_locator() {}
+
+        // fewer than two lines give the bounding triangle alone
+        virtual void build(const std::vector<line> & lines) = 0;
+
+        // face of arrangement() containing p, its outer face for points outside the bounding triangle
+        virtual uint32_t locate(const point_2 & p) const = 0;
+
+        virtual const DCEL & arrangement() const = 0;
+    };
+}
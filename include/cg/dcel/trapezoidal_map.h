@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cg/dcel/point_locator.h>
+
+#include <random>
+
+namespace cg {
+
+    // Trapezoidal map of the edges of DCEL(lines) with its search DAG, built by randomized incremental
+    // construction: expected O(m log m) for m edges and O(log m) per query.
+    // Points are compared lexicographically (the symbolic shear), so vertical edges and vertices
+    // with equal x need no special care.
+    struct trapezoidal_map : point_locator
+    {
+        struct segment
+        {
+            uint32_t left, right; // vertices, left is lexicographically smaller
+            uint32_t face;        // face below the segment
+        };
+
+        struct trapezoid
+        {
+            uint32_t top, bottom;   // segments, no_index when unbounded
+            uint32_t leftp, rightp; // vertices of the walls, no_index when unbounded
+            uint32_t node;          // leaf of the trapezoid
+        };
+
+        enum node_kind { X_NODE, Y_NODE, LEAF };
+
+        struct search_node
+        {
+            node_kind kind;
+            uint32_t id;     // vertex, segment or trapezoid
+            uint32_t lo, hi; // before / after the vertex, below / above the segment
+        };
+
+        DCEL dcel;
+        std::vector<segment> segments;
+        std::vector<trapezoid> trapezoids;
+        std::vector<search_node> nodes; // nodes[0] is the root
+        unsigned seed;                  // of the insertion order
+
+        trapezoidal_map()
+            : seed(0)
+        {}
+
+        void build(const std::vector<line> & lines)
+        {
+            dcel = DCEL(lines);
+            segments.clear();
+            trapezoids.clear();
+            nodes.clear();
+
+            // one segment per edge, from the half-edge running right to left: the face on its left is below
+            for (uint32_t f = 0; f < dcel.faces.size(); f++) {
+                uint32_t e = dcel.faces[f].e;
+                do {
+                    uint32_t u = dcel.origin(e), v = dcel.origin(dcel.next(e));
+                    if (compare(v, u) < 0) {
+                        segments.push_back(segment{v, u, f});
+                    }
+                    e = dcel.next(e);
+                } while (e != dcel.faces[f].e);
+            }
+            std::mt19937 gen(seed);
+            std::shuffle(segments.begin(), segments.end(), gen);
+
+            new_trapezoid(no_index, no_index, no_index, no_index);
+            for (uint32_t s = 0; s < segments.size(); s++) {
+                insert(s);
+            }
+        }
+
+        uint32_t locate(const point_2 & p) const
+        {
+            line_cross q(p);
+            uint32_t n = 0;
+            while (nodes[n].kind != LEAF) {
+                const search_node & node = nodes[n];
+                if (node.kind == X_NODE) {
+                    n = (compare(q, node.id) < 0 ? node.lo : node.hi);
+                } else {
+                    n = (turn(node.id, q) == CG_RIGHT ? node.lo : node.hi);
+                }
+            }
+
+            uint32_t top = trapezoids[nodes[n].id].top;
+            return top == no_index ? dcel.edges[0].face : segments[top].face;
+        }
+
+        const DCEL & arrangement() const
+        {
+            return dcel;
+        }
+
+    private:
+        std::vector<uint32_t> crossed;
+        std::vector<trapezoid> old;
+        std::vector<uint32_t> upper, lower;
+
+        // lexicographic order of the point p and the vertex v
+        int compare(const line_cross & p, uint32_t v) const
+        {
+            int res = x_dif(p, dcel.vertex_cross(v));
+            return res != 0 ? res : int(y_dif(p, dcel.vertex_cross(v)));
+        }
+
+        int compare(uint32_t u, uint32_t v) const
+        {
+            return u == v ? 0 : compare(dcel.vertex_cross(u), v);
+        }
+
+        // CG_LEFT when the point is above the segment
+        orientation_t turn(uint32_t s, const line_cross & p) const
+        {
+            const segment & seg = segments[s];
+            return orientation(dcel.vertex_cross(seg.left), dcel.vertex_cross(seg.right), p);
+        }
+
+        orientation_t turn(uint32_t s, uint32_t v) const
+        {
+            return turn(s, dcel.vertex_cross(v));
+        }
+
+        // segments do not cross, so over their common x range one of them is above the other
+        bool above(uint32_t s, uint32_t t) const
+        {
+            const segment & a = segments[s], & b = segments[t];
+            if (a.left == b.left) {
+                return turn(t, a.right) == CG_LEFT;
+            }
+            if (compare(a.left, b.left) > 0) {
+                return turn(t, a.left) == CG_LEFT;
+            }
+            return turn(s, b.left) == CG_RIGHT;
+        }
+
+        // trapezoid crossed by segment s right after its point at the wall of vertex r
+        uint32_t find(uint32_t s, uint32_t r) const
+        {
+            uint32_t n = 0;
+            while (nodes[n].kind != LEAF) {
+                const search_node & node = nodes[n];
+                if (node.kind == X_NODE) {
+                    n = (compare(node.id, r) <= 0 ? node.hi : node.lo);
+                } else {
+                    n = (above(s, node.id) ? node.hi : node.lo);
+                }
+            }
+            return nodes[n].id;
+        }
+
+        uint32_t new_node(node_kind kind, uint32_t id, uint32_t lo, uint32_t hi)
+        {
+            nodes.push_back(search_node{kind, id, lo, hi});
+            return nodes.size() - 1;
+        }
+
+        uint32_t new_trapezoid(uint32_t top, uint32_t bottom, uint32_t leftp, uint32_t rightp)
+        {
+            trapezoids.push_back(trapezoid{top, bottom, leftp, rightp, new_node(LEAF, trapezoids.size(), no_index, no_index)});
+            return trapezoids.size() - 1;
+        }
+
+        void insert(uint32_t s)
+        {
+            uint32_t p = segments[s].left, q = segments[s].right;
+
+            crossed.assign(1, find(s, p));
+            while (trapezoids[crossed.back()].rightp != no_index && compare(q, trapezoids[crossed.back()].rightp) > 0) {
+                crossed.push_back(find(s, trapezoids[crossed.back()].rightp));
+            }
+
+            size_t k = crossed.size();
+            old.clear();
+            for (uint32_t t : crossed) {
+                old.push_back(trapezoids[t]);
+            }
+
+            // pieces above and below s, neighbours merge where the wall between them ends on the other side of s
+            upper.resize(k);
+            lower.resize(k);
+            for (size_t j = 0; j < k; j++) {
+                bool wall_above = (j > 0 && turn(s, old[j].leftp) == CG_LEFT);
+                upper[j] = (j == 0 || wall_above ? new_trapezoid(old[j].top, s, j == 0 ? p : old[j].leftp, no_index) : upper[j - 1]);
+                lower[j] = (j == 0 || !wall_above ? new_trapezoid(s, old[j].bottom, j == 0 ? p : old[j].leftp, no_index) : lower[j - 1]);
+            }
+            for (size_t j = 0; j < k; j++) {
+                trapezoids[upper[j]].rightp = trapezoids[lower[j]].rightp = (j + 1 == k ? q : old[j].rightp);
+            }
+
+            for (size_t j = 0; j < k; j++) {
+                uint32_t root = new_node(Y_NODE, s, trapezoids[lower[j]].node, trapezoids[upper[j]].node);
+                if (j + 1 == k && old[j].rightp != q) {
+                    uint32_t right = new_trapezoid(old[j].top, old[j].bottom, q, old[j].rightp);
+                    root = new_node(X_NODE, q, root, trapezoids[right].node);
+                }
+                if (j == 0 && old[j].leftp != p) {
+                    uint32_t left = new_trapezoid(old[j].top, old[j].bottom, old[j].leftp, p);
+                    root = new_node(X_NODE, p, trapezoids[left].node, root);
+                }
+
+                // the leaf of the crossed trapezoid becomes the root of its replacement
+                nodes[old[j].node] = nodes[root];
+                nodes.pop_back();
+            }
+        }
+    };
+}
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cg/primitives/segment.h>
+#include <cg/operations/orientation.h>
+#include <cg/operations/has_intersection/segment_segment.h>
+
+#include <boost/numeric/interval.hpp>
+#include <gmpxx.h>
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace cg
+{
+namespace detail
+{
+   // crossing of the non parallel segments ab and cd, computed on demand
+   struct sweep_crossing
+   {
+      sweep_crossing(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
+         : a(a), b(b), c(c), d(d)
+      {}
+
+      point_2t<mpq_class> const & exact() const
+      {
+         if (!point)
+         {
+            mpq_class abx = mpq_class(b.x) - a.x, aby = mpq_class(b.y) - a.y;
+            mpq_class cdx = mpq_class(d.x) - c.x, cdy = mpq_class(d.y) - c.y;
+            mpq_class u = ((mpq_class(c.x) - a.x) * cdy - (mpq_class(c.y) - a.y) * cdx) / (abx * cdy - aby * cdx);
+            point.reset(new point_2t<mpq_class>(a.x + u * abx, a.y + u * aby));
+         }
+         return *point;
+      }
+
+      // crossing of the same segments, found again
+      bool same(sweep_crossing const & o) const
+      {
+         return (a == o.a && b == o.b && c == o.c && d == o.d) || (a == o.c && b == o.d && c == o.a && d == o.b);
+      }
+
+      point_2 a, b, c, d;
+      mutable std::unique_ptr<point_2t<mpq_class> > point;
+   };
+
+   // an event of the sweep: a segment end, held exactly in p, or a crossing, held in q and within
+   // x_err and y_err of p
+   struct sweep_point
+   {
+      sweep_point()
+         : x_err(0), y_err(0)
+      {}
+
+      explicit sweep_point(point_2 const & p)
+         : p(p), x_err(0), y_err(0)
+      {}
+
+      // the crossing bounded in interval arithmetic, or exactly when that fails
+      sweep_point(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
+         : q(std::make_shared<sweep_crossing>(a, b, c, d))
+      {
+         typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
+
+         {
+            boost::numeric::interval<double>::traits_type::rounding _;
+            interval abx = interval(b.x) - a.x, aby = interval(b.y) - a.y;
+            interval cdx = interval(d.x) - c.x, cdy = interval(d.y) - c.y;
+            interval den = abx * cdy - aby * cdx;
+            if (!zero_in(den))
+            {
+               interval u = ((interval(c.x) - a.x) * cdy - (interval(c.y) - a.y) * cdx) / den;
+               interval x = a.x + u * abx, y = a.y + u * aby;
+               p = point_2(median(x), median(y));
+               x_err = width(x);
+               y_err = width(y);
+               return;
+            }
+         }
+
+         p = point_2(q->exact().x.get_d(), q->exact().y.get_d());
+         x_err = fabs(p.x) * std::numeric_limits<double>::epsilon() + std::numeric_limits<double>::denorm_min();
+         y_err = fabs(p.y) * std::numeric_limits<double>::epsilon() + std::numeric_limits<double>::denorm_min();
+      }
+
+      mpq_class x() const { return q ? q->exact().x : mpq_class(p.x); }
+      mpq_class y() const { return q ? q->exact().y : mpq_class(p.y); }
+
+      point_2 p;
+      double x_err, y_err;
+      std::shared_ptr<sweep_crossing const> q;
+   };
+
+   // sign of a - b by x, then by y
+   inline int compare(sweep_point const & a, sweep_point const & b)
+   {
+      if (a.p.x + a.x_err < b.p.x - b.x_err)
+         return -1;
+      if (a.p.x - a.x_err > b.p.x + b.x_err)
+         return 1;
+      if (a.q && b.q && a.q->same(*b.q))
+         return 0;
+      if (int c = (a.q || b.q) ? sgn(a.x() - b.x()) : (a.p.x > b.p.x) - (a.p.x < b.p.x))
+         return c;
+
+      if (a.p.y + a.y_err < b.p.y - b.y_err)
+         return -1;
+      if (a.p.y - a.y_err > b.p.y + b.y_err)
+         return 1;
+      return (a.q || b.q) ? sgn(a.y() - b.y()) : (a.p.y > b.p.y) - (a.p.y < b.p.y);
+   }
+
+   struct sweep_point_less
+   {
+      bool operator () (sweep_point const & a, sweep_point const & b) const
+      {
+         return compare(a, b) < 0;
+      }
+   };
+
+   // Bentley-Ottmann sweep over the segments from left to right (by x, then by y). The status holds the
+   // segments crossing the sweep line in the order of their y at the current event; the segments through
+   // the event are ordered by slope, as right after it, and the vertical ones above them. All segments
+   // through an event meet there and are reported as pairs, a collinear pair only where it starts to overlap.
+   // Predicates are exact: a double filter, then rationals for the crossings and the status order.
+   // With colours, segments of one colour are taken not to cross (they may touch): only pairs of
+   // different colours are reported, and neighbours of one colour are not tested for crossings.
+   class segment_sweep
+   {
+   public:
+      explicit segment_sweep(std::vector<segment_2> const & segments, std::vector<uint8_t> const & colours = std::vector<uint8_t>())
+         : colour_(colours)
+         , status_(status_less{this})
+      {
+         for (segment_2 const & s : segments)
+         {
+            edge e;
+            e.a = min(s);
+            e.b = max(s);
+            e.dx = e.b.x - e.a.x;
+            e.dy = e.b.y - e.a.y;
+            e.slope = e.dx > 0 ? e.dy / e.dx : 0;
+            edges_.push_back(e);
+         }
+      }
+
+      // f(i, j, p) for every pair of intersecting segments i < j, with p their first common point (rounded)
+      template <class F>
+      void run(F f)
+      {
+         for (uint32_t i = 0; i != edges_.size(); ++i)
+         {
+            queue_[sweep_point(edges_[i].a)].starting.push_back(i);
+            queue_[sweep_point(edges_[i].b)].passing.push_back(i);
+         }
+
+         std::vector<uint32_t> through;
+         marked_.assign(edges_.size(), 0);
+         for (size_t event = 1; !queue_.empty(); ++event)
+         {
+            queue_t::iterator ev = queue_.begin();
+            current_ = ev->first;
+            through.swap(ev->second.starting);
+            for (uint32_t i : ev->second.passing)
+               marked_[i] = event;
+            event_ = event;
+            queue_.erase(ev);
+            size_t starting = through.size();
+
+            status_t::iterator lo = status_.lower_bound(probe_low), hi = status_.lower_bound(probe_high);
+            through.insert(through.end(), lo, hi);
+            status_.erase(lo, hi);
+
+            for (size_t k = 0; k != through.size(); ++k)
+               for (size_t l = 0; l != k; ++l)
+                  if (!same_colour(through[k], through[l]) && (l < starting || !collinear(through[k], through[l])))
+                     f(std::min(through[k], through[l]), std::max(through[k], through[l]), current_.p);
+
+            bool inserted = false;
+            for (size_t k = 0; k != through.size(); ++k)
+            {
+               edge const & e = edges_[through[k]];
+               marked_[through[k]] = event;
+               if (e.a != e.b && compare(sweep_point(e.b), current_) != 0)
+               {
+                  status_.insert(through[k]);
+                  inserted = true;
+               }
+            }
+            through.clear();
+
+            status_t::iterator first = status_.lower_bound(probe_low);
+            if (!inserted)
+            {
+               if (first != status_.begin() && first != status_.end())
+                  check_crossing(*std::prev(first), *first);
+               continue;
+            }
+
+            status_t::iterator last = std::prev(status_.lower_bound(probe_high));
+            if (first != status_.begin())
+               check_crossing(*std::prev(first), *first);
+            if (std::next(last) != status_.end())
+               check_crossing(*last, *std::next(last));
+         }
+      }
+
+   private:
+      enum : uint32_t { probe_low = uint32_t(-2), probe_high = uint32_t(-1) };
+
+      struct edge
+      {
+         point_2 a, b; // a < b
+         double dx, dy, slope;
+      };
+
+      struct status_less
+      {
+         segment_sweep const * sweep;
+
+         bool operator () (uint32_t i, uint32_t j) const
+         {
+            return sweep->below(i, j);
+         }
+      };
+
+      typedef std::set<uint32_t, status_less> status_t;
+      struct event_segments
+      {
+         std::vector<uint32_t> starting; // segments starting at the event
+         std::vector<uint32_t> passing;  // other segments known to pass it
+      };
+
+      typedef std::map<sweep_point, event_segments, sweep_point_less> queue_t;
+
+      // probes, vertical segments and the segments known to pass the event are at its height
+      bool at_event(uint32_t i) const
+      {
+         return i >= probe_low || edges_[i].dx == 0 || marked_[i] == event_;
+      }
+
+      // order of the classes at one height
+      int rank(uint32_t i) const
+      {
+         if (i == probe_low)
+            return 0;
+         if (i == probe_high)
+            return 3;
+         return edges_[i].dx == 0 ? 2 : 1;
+      }
+
+      // y of the non vertical segment i at the x of the event, with a bound of its error
+      double y_at(uint32_t i, double & err) const
+      {
+         edge const & e = edges_[i];
+         double t = (current_.p.x - e.a.x) * e.slope;
+         err = (fabs(e.a.y) + fabs(t)) * 16 * std::numeric_limits<double>::epsilon() + 2 * fabs(e.slope) * current_.x_err;
+         return e.a.y + t;
+      }
+
+      // sign of y of the non vertical segment i at the event minus y of the event
+      int y_sign(uint32_t i) const
+      {
+         double err, res = y_at(i, err) - current_.p.y;
+         err += current_.y_err;
+         if (res > err)
+            return 1;
+         if (res < -err)
+            return -1;
+
+         edge const & e = edges_[i];
+         return sgn((mpq_class(e.a.y) - current_.y()) * (mpq_class(e.b.x) - e.a.x)
+                    + (current_.x() - e.a.x) * (mpq_class(e.b.y) - e.a.y));
+      }
+
+      // sign of y of i minus y of j at the event
+      int y_dif(uint32_t i, uint32_t j) const
+      {
+         if (at_event(i))
+            return at_event(j) ? 0 : -y_sign(j);
+         if (at_event(j))
+            return y_sign(i);
+
+         double ei, ej, res = y_at(i, ei) - y_at(j, ej);
+         if (res > ei + ej)
+            return 1;
+         if (res < -ei - ej)
+            return -1;
+
+         edge const & s = edges_[i], & t = edges_[j];
+         mpq_class x = current_.x(), sdx = mpq_class(s.b.x) - s.a.x, tdx = mpq_class(t.b.x) - t.a.x;
+         return sgn((s.a.y * sdx + (x - s.a.x) * (mpq_class(s.b.y) - s.a.y)) * tdx
+                    - (t.a.y * tdx + (x - t.a.x) * (mpq_class(t.b.y) - t.a.y)) * sdx);
+      }
+
+      // sign of the slope of i minus the slope of j, both non vertical
+      int slope_dif(uint32_t i, uint32_t j) const
+      {
+         edge const & s = edges_[i], & t = edges_[j];
+         double l = s.dy * t.dx, r = t.dy * s.dx;
+         double res = l - r, eps = (fabs(l) + fabs(r)) * 8 * std::numeric_limits<double>::epsilon();
+         if (res > eps)
+            return 1;
+         if (res < -eps)
+            return -1;
+
+         return sgn((mpq_class(s.b.y) - s.a.y) * (mpq_class(t.b.x) - t.a.x)
+                    - (mpq_class(t.b.y) - t.a.y) * (mpq_class(s.b.x) - s.a.x));
+      }
+
+      bool below(uint32_t i, uint32_t j) const
+      {
+         if (i == j)
+            return false;
+         if (int c = y_dif(i, j))
+            return c < 0;
+         if (rank(i) != rank(j))
+            return rank(i) < rank(j);
+         if (rank(i) == 1)
+            if (int c = slope_dif(i, j))
+               return c < 0;
+         return i < j;
+      }
+
+      // a common end is on the line without going through the exact stage of orientation
+      bool collinear(uint32_t i, uint32_t j) const
+      {
+         edge const & s = edges_[i], & t = edges_[j];
+         return (t.a == s.a || t.a == s.b || orientation(s.a, s.b, t.a) == CG_COLLINEAR)
+             && (t.b == s.a || t.b == s.b || orientation(s.a, s.b, t.b) == CG_COLLINEAR);
+      }
+
+      bool same_colour(uint32_t i, uint32_t j) const
+      {
+         return !colour_.empty() && colour_[i] == colour_[j];
+      }
+
+      // the crossing of neighbours i and j right of the event becomes an event
+      void check_crossing(uint32_t i, uint32_t j)
+      {
+         edge const & s = edges_[i], & t = edges_[j];
+         if (same_colour(i, j) || !has_intersection(segment_2(s.a, s.b), segment_2(t.a, t.b)) || collinear(i, j))
+            return;
+
+         sweep_point p(s.a, s.b, t.a, t.b);
+         if (compare(p, current_) > 0)
+         {
+            event_segments & e = queue_[p];
+            e.passing.push_back(i);
+            e.passing.push_back(j);
+         }
+      }
+
+      std::vector<edge> edges_;
+      std::vector<uint8_t> colour_;
+      sweep_point current_;
+      size_t event_;
+      std::vector<size_t> marked_; // the last event each segment is known to pass
+      status_t status_;
+      queue_t queue_;
+   };
+}
+
+   // f(i, j, p) for every pair of intersecting segments, i < j, in the order of the sweep, with p the first
+   // common point of the two (the leftmost one, rounded). In O((n + k) log n) for k pairs, save for groups of
+   // collinear overlapping segments, which are met pairwise at each event inside the overlap.
+   template <class F>
+   void for_each_intersection(std::vector<segment_2> const & segments, F f)
+   {
+      detail::segment_sweep(segments).run(f);
+   }
+
+   // pairs (i, j), i < j, of intersecting segments
+   template <class OutIter>
+   OutIter intersecting_pairs(std::vector<segment_2> const & segments, OutIter out)
+   {
+      for_each_intersection(segments, [&out](size_t i, size_t j, point_2 const &)
+      {
+         *out++ = std::make_pair(i, j);
+      });
+      return out;
+   }
+}
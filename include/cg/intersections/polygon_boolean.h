@@ -0,0 +1,376 @@
+#pragma once
+
+#include <cg/intersections/bentley_ottmann.h>
+#include <cg/operations/convex.h>
+#include <cg/operations/convex_intersection.h>
+#include <cg/operations/contains/prepared_convex_polygon.h>
+#include <cg/operations/orientation.h>
+#include <cg/primitives/contour.h>
+#include <cg/common/parallel.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace cg
+{
+   enum boolean_operation_t
+   {
+      CG_UNION,
+      CG_INTERSECTION,
+      CG_DIFFERENCE
+   };
+
+namespace detail
+{
+   // piece of the edges of the two polygons cut at all their common points, l < r;
+   // bit k of the flags stands for polygon k (0 for the first operand, 1 for the second)
+   struct overlay_piece
+   {
+      point_2 l, r;
+      uint8_t flip;  // crossing the piece changes the membership in the polygon (an odd number of its edges run along)
+      uint8_t below; // the region below the piece, right of it when vertical, is in the polygon
+   };
+
+   inline bool in_result(uint8_t inside, boolean_operation_t op)
+   {
+      bool a = inside & 1, b = inside & 2;
+      switch (op)
+      {
+      case CG_UNION:        return a || b;
+      case CG_INTERSECTION: return a && b;
+      default:              return a && !b;
+      }
+   }
+
+   // s below t in the sweep, for pieces which do not cross, both over the sweep position (the later left end)
+   struct piece_below
+   {
+      std::vector<overlay_piece> const * pieces;
+
+      bool operator () (uint32_t i, uint32_t j) const
+      {
+         if (i == j)
+            return false;
+
+         overlay_piece const & s = (*pieces)[i], & t = (*pieces)[j];
+         orientation_t o;
+         if (s.l == t.l)
+         {
+            if ((o = orientation(s.l, s.r, t.r)) != CG_COLLINEAR)
+               return o == CG_LEFT;
+         }
+         else if (t.l < s.l)
+         {
+            if ((o = orientation(t.l, t.r, s.l)) != CG_COLLINEAR || (o = orientation(t.l, t.r, s.r)) != CG_COLLINEAR)
+               return o == CG_RIGHT;
+         }
+         else
+         {
+            if ((o = orientation(s.l, s.r, t.l)) != CG_COLLINEAR || (o = orientation(s.l, s.r, t.r)) != CG_COLLINEAR)
+               return o == CG_LEFT;
+         }
+         return i < j;
+      }
+   };
+
+   // the edges of a (flag bit 0) and of b (bit 1) cut at their common points found by the sweep, the pieces
+   // running along each other merged into one, the pieces of no effect (an even number of edges of each
+   // polygon along them) dropped. Crossings are rounded to the nearest doubles.
+   inline std::vector<overlay_piece> overlay_pieces(std::vector<contour_2> const & a, std::vector<contour_2> const & b)
+   {
+      std::vector<segment_2> segments;
+      std::vector<uint8_t> owner;
+      for (uint8_t k = 0; k != 2; ++k)
+         for (contour_2 const & c : (k == 0 ? a : b))
+            for (size_t l = 0; l != c.size(); ++l)
+            {
+               point_2 const & p = c[l], & q = c[l + 1 == c.size() ? 0 : l + 1];
+               if (p == q)
+                  continue;
+               segments.push_back(segment_2(p, q));
+               owner.push_back(uint8_t(1 << k));
+            }
+
+      std::vector<std::vector<point_2> > cuts(segments.size());
+      for_each_intersection(segments, [&](size_t i, size_t j, point_2 const & p)
+      {
+         // neighbour sides of a contour share an end, which is on the line without the exact stage of orientation
+         segment_2 const & s = segments[i], & t = segments[j];
+         auto on_line = [&s](point_2 const & p) { return p == s[0] || p == s[1] || orientation(s[0], s[1], p) == CG_COLLINEAR; };
+         if (on_line(t[0]) && on_line(t[1]))
+         {
+            // overlap, each one is cut at the ends of the other
+            cuts[i].push_back(t[0]);
+            cuts[i].push_back(t[1]);
+            cuts[j].push_back(s[0]);
+            cuts[j].push_back(s[1]);
+         }
+         else
+         {
+            cuts[i].push_back(p);
+            cuts[j].push_back(p);
+         }
+      });
+
+      std::vector<overlay_piece> pieces;
+      for (size_t i = 0; i != segments.size(); ++i)
+      {
+         point_2 l = min(segments[i]), r = max(segments[i]);
+         std::vector<point_2> & cut = cuts[i];
+
+         // a rounded crossing next to an end may fall out of the segment
+         cut.erase(std::remove_if(cut.begin(), cut.end(), [&](point_2 const & p) { return !(l < p && p < r); }), cut.end());
+         std::sort(cut.begin(), cut.end());
+         cut.erase(std::unique(cut.begin(), cut.end()), cut.end());
+         cut.push_back(r);
+
+         for (point_2 const & p : cut)
+         {
+            overlay_piece piece = { l, p, owner[i], 0 };
+            pieces.push_back(piece);
+            l = p;
+         }
+      }
+
+      std::sort(pieces.begin(), pieces.end(), [](overlay_piece const & s, overlay_piece const & t)
+      {
+         return s.l < t.l || (s.l == t.l && s.r < t.r);
+      });
+
+      size_t m = 0;
+      for (size_t i = 0; i != pieces.size(); ++i)
+      {
+         if (m != 0 && pieces[m - 1].l == pieces[i].l && pieces[m - 1].r == pieces[i].r)
+            pieces[m - 1].flip ^= pieces[i].flip;
+         else
+            pieces[m++] = pieces[i];
+      }
+      pieces.resize(m);
+
+      pieces.erase(std::remove_if(pieces.begin(), pieces.end(), [](overlay_piece const & s) { return s.flip == 0; }), pieces.end());
+      return pieces;
+   }
+
+   // the regions below the pieces, by a sweep in the order of points (x, then y). Pieces are inserted at
+   // their left ends, the ones starting together from the lowest, and take the region above the piece
+   // below them in the status; at one point the pieces ending there leave first.
+   inline void classify(std::vector<overlay_piece> & pieces)
+   {
+      typedef std::set<uint32_t, piece_below> status_t;
+      piece_below less = { &pieces };
+      status_t status(less);
+      std::vector<status_t::iterator> pos(pieces.size());
+
+      // event 2 i at the left end of piece i, 2 i + 1 at the right one
+      std::vector<uint32_t> events(2 * pieces.size());
+      for (uint32_t e = 0; e != events.size(); ++e)
+         events[e] = e;
+
+      auto point = [&pieces](uint32_t e) -> point_2 const & { return e % 2 ? pieces[e / 2].r : pieces[e / 2].l; };
+      std::sort(events.begin(), events.end(), [&](uint32_t e, uint32_t f)
+      {
+         return point(e) < point(f) || (point(e) == point(f) && e % 2 > f % 2);
+      });
+
+      std::vector<uint32_t> starting;
+      for (size_t e = 0; e != events.size(); )
+      {
+         point_2 p = point(events[e]);
+         for (; e != events.size() && events[e] % 2 && point(events[e]) == p; ++e)
+            status.erase(pos[events[e] / 2]);
+
+         starting.clear();
+         for (; e != events.size() && point(events[e]) == p; ++e)
+            starting.push_back(events[e] / 2);
+         std::sort(starting.begin(), starting.end(), less);
+
+         for (uint32_t i : starting)
+         {
+            status_t::iterator it = pos[i] = status.insert(i).first;
+            if (it == status.begin())
+               pieces[i].below = 0;
+            else
+            {
+               overlay_piece const & prev = pieces[*std::prev(it)];
+               pieces[i].below = prev.below ^ prev.flip;
+            }
+         }
+      }
+   }
+
+   // boundary of the result, from the pieces with the result on one side only, directed with the result
+   // on the left and joined into contours. Where several contours meet at a vertex each one turns to the
+   // first outgoing edge clockwise from the way it came in, so contours touching at a vertex stay apart.
+   inline std::vector<contour_2> result_contours(std::vector<overlay_piece> const & pieces, boolean_operation_t op)
+   {
+      std::vector<std::pair<point_2, point_2> > edges;
+      for (overlay_piece const & s : pieces)
+      {
+         bool below = in_result(s.below, op), above = in_result(s.below ^ s.flip, op);
+         if (below != above)
+            edges.push_back(above ? std::make_pair(s.l, s.r) : std::make_pair(s.r, s.l));
+      }
+      std::sort(edges.begin(), edges.end());
+
+      std::vector<bool> used(edges.size());
+      std::vector<contour_2> res;
+      for (size_t first = 0; first != edges.size(); ++first)
+      {
+         if (used[first])
+            continue;
+
+         std::vector<point_2> pts;
+         for (size_t e = first; !used[e]; )
+         {
+            used[e] = true;
+            pts.push_back(edges[e].first);
+
+            point_2 const & u = edges[e].first, & v = edges[e].second;
+            std::vector<std::pair<point_2, point_2> >::const_iterator lo = std::lower_bound(edges.begin(), edges.end(), std::make_pair(v, v),
+               [](std::pair<point_2, point_2> const & s, std::pair<point_2, point_2> const & t) { return s.first < t.first; });
+
+            // clockwise from the way back to u: 0 less than a half turn, 1 a half turn, 2 more
+            auto half = [&](point_2 const & w)
+            {
+               orientation_t o = orientation(v, u, w);
+               return o == CG_RIGHT ? 0 : o == CG_COLLINEAR ? 1 : 2;
+            };
+
+            size_t next = lo - edges.begin();
+            for (size_t k = next + 1; k != edges.size() && edges[k].first == v; ++k)
+            {
+               point_2 const & w = edges[k].second, & best = edges[next].second;
+               int hw = half(w), hb = half(best);
+               if (hw < hb || (hw == hb && orientation(v, best, w) == CG_LEFT))
+                  next = k;
+            }
+            e = next;
+         }
+
+         pts.resize(drop_collinear(pts.data(), pts.data() + pts.size()) - pts.data());
+         if (pts.size() >= 3)
+            res.push_back(contour_2(pts));
+      }
+      return res;
+   }
+
+   inline bool convex_ccw(std::vector<contour_2> const & p)
+   {
+      return p.size() == 1 && p[0].size() >= 3 && counterclockwise(p[0]) && convex(p[0]);
+   }
+
+   inline bool disjoint_boxes(std::vector<contour_2> const & a, std::vector<contour_2> const & b)
+   {
+      double box[2][4] = {};
+      for (size_t k = 0; k != 2; ++k)
+      {
+         std::vector<contour_2> const & p = k == 0 ? a : b;
+         bool first = true;
+         for (contour_2 const & c : p)
+            for (point_2 const & v : c)
+            {
+               if (first || v.x < box[k][0]) box[k][0] = v.x;
+               if (first || v.y < box[k][1]) box[k][1] = v.y;
+               if (first || v.x > box[k][2]) box[k][2] = v.x;
+               if (first || v.y > box[k][3]) box[k][3] = v.y;
+               first = false;
+            }
+         if (first)
+            return true;
+      }
+      return box[0][2] < box[1][0] || box[1][2] < box[0][0] || box[0][3] < box[1][1] || box[1][3] < box[0][1];
+   }
+
+   inline std::vector<contour_2> sweep_boolean(std::vector<contour_2> const & a, std::vector<contour_2> const & b,
+                                               boolean_operation_t op)
+   {
+      std::vector<overlay_piece> pieces = overlay_pieces(a, b);
+      classify(pieces);
+      return result_contours(pieces, op);
+   }
+}
+
+   // Union, intersection or difference (a minus b) of polygons given as sets of contours under the even-odd
+   // rule: any orientation, holes as contours inside, contours may cross and touch. The edges are cut at
+   // their common points by the Bentley-Ottmann sweep, then a second sweep over the pieces, which do not
+   // cross any more, finds the regions on the two sides of each piece (Martinez-Rueda), keeping the pieces
+   // with the result on one side. The result has ccw outer contours and cw holes, without collinear
+   // vertices. All predicates are exact; crossings are rounded to doubles. O((n + k) log n) for n edges
+   // and k intersecting pairs. Convex contours of ccw orientation are intersected by convex_intersection
+   // in O(n + m), and polygons with disjoint bounding boxes have no intersection.
+   inline std::vector<contour_2> boolean_operation(std::vector<contour_2> const & a, std::vector<contour_2> const & b,
+                                                   boolean_operation_t op)
+   {
+      if (op == CG_INTERSECTION)
+      {
+         if (detail::disjoint_boxes(a, b))
+            return std::vector<contour_2>();
+
+         if (detail::convex_ccw(a) && detail::convex_ccw(b))
+         {
+            contour_2 c = convex_intersection(a[0], b[0]);
+            return c.size() == 0 ? std::vector<contour_2>() : std::vector<contour_2>(1, c);
+         }
+      }
+
+      return detail::sweep_boolean(a, b, op);
+   }
+
+   inline std::vector<contour_2> polygon_union(std::vector<contour_2> const & a, std::vector<contour_2> const & b)
+   {
+      return boolean_operation(a, b, CG_UNION);
+   }
+
+   inline std::vector<contour_2> polygon_intersection(std::vector<contour_2> const & a, std::vector<contour_2> const & b)
+   {
+      return boolean_operation(a, b, CG_INTERSECTION);
+   }
+
+   inline std::vector<contour_2> polygon_difference(std::vector<contour_2> const & a, std::vector<contour_2> const & b)
+   {
+      return boolean_operation(a, b, CG_DIFFERENCE);
+   }
+
+   // out[k] is the intersection of polygons[k] with the window, spreading the polygons over the threads.
+   // A convex window of ccw orientation is prepared once: convex polygons go through convex_intersection,
+   // and polygons with all vertices in it are only brought to the form of the results of boolean_operation.
+   inline void clip(std::vector<std::vector<contour_2> > const & polygons, std::vector<contour_2> const & window,
+                    std::vector<std::vector<contour_2> > & out, size_t threads = 0)
+   {
+      bool convex_window = detail::convex_ccw(window);
+      prepared_convex_polygon prepared;
+      if (convex_window)
+         prepared = prepared_convex_polygon(window[0]);
+
+      out.assign(polygons.size(), std::vector<contour_2>());
+      common::parallel_for(polygons.size(), 64, [&](size_t first, size_t last)
+      {
+         for (size_t k = first; k != last; ++k)
+         {
+            std::vector<contour_2> const & p = polygons[k];
+            if (detail::disjoint_boxes(p, window))
+               continue;
+
+            if (convex_window && detail::convex_ccw(p))
+            {
+               contour_2 c = convex_intersection(p[0], window[0]);
+               if (c.size() != 0)
+                  out[k].push_back(c);
+               continue;
+            }
+
+            bool inside = convex_window;
+            for (size_t l = 0; inside && l != p.size(); ++l)
+               for (size_t v = 0; inside && v != p[l].size(); ++v)
+                  inside = prepared.contains(p[l][v]);
+
+            out[k] = inside ? detail::sweep_boolean(p, std::vector<contour_2>(), CG_UNION)
+                            : detail::sweep_boolean(p, window, CG_INTERSECTION);
+         }
+      }, threads);
+   }
+}
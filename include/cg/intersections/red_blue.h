@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cg/intersections/bentley_ottmann.h>
+#include <cg/primitives/contour.h>
+
+#include <vector>
+
+namespace cg
+{
+   // sides of the contours of a layer, contour after contour, side l of a contour from its vertex l to the next
+   inline std::vector<segment_2> layer_segments(std::vector<contour_2> const & layer)
+   {
+      std::vector<segment_2> res;
+      for (contour_2 const & c : layer)
+         for (size_t l = 0; l != c.size(); ++l)
+            res.push_back(segment_2(c[l], c[l + 1 == c.size() ? 0 : l + 1]));
+      return res;
+   }
+
+   // f(r, b, p) for every red segment r and blue segment b that intersect, with p their first common point
+   // (the leftmost one, rounded). The segments of one colour must not cross each other, they may touch,
+   // as the sides of the polygons of a layer. One sweep over both colours in O((n + k) log n), for
+   // n segments and k red blue pairs, touching pairs of one colour included.
+   template <class F>
+   void for_each_red_blue_intersection(std::vector<segment_2> const & red, std::vector<segment_2> const & blue, F f)
+   {
+      std::vector<segment_2> segments(red);
+      segments.insert(segments.end(), blue.begin(), blue.end());
+      std::vector<uint8_t> colours(red.size(), 0);
+      colours.resize(segments.size(), 1);
+
+      size_t n = red.size();
+      detail::segment_sweep(segments, colours).run([&](size_t i, size_t j, point_2 const & p)
+      {
+         f(i, j - n, p);
+      });
+   }
+
+   // pairs (r, b) of intersecting red and blue segments
+   template <class OutIter>
+   OutIter red_blue_pairs(std::vector<segment_2> const & red, std::vector<segment_2> const & blue, OutIter out)
+   {
+      for_each_red_blue_intersection(red, blue, [&out](size_t r, size_t b, point_2 const &)
+      {
+         *out++ = std::make_pair(r, b);
+      });
+      return out;
+   }
+}
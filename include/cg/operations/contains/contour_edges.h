@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cg/operations/contains/contour_point.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cg
+{
+   // contains for many queries against one contour. The edges are copied lower end first into separate
+   // coordinate arrays, sorted by the lower end and cut into blocks of edge_block, each with the highest
+   // upper end of its edges, so a query skips the blocks out of its y range and stops at the first block
+   // above it. In the remaining blocks the floating point filter of orientation runs as a flat branch free
+   // loop, which the compiler vectorizes where the target has wide vector compares (-mavx2), and only the
+   // edges it could not decide go through ray_crossing. Batches of queries take the blocks in turn.
+   struct contour_edges
+   {
+      enum { edge_block = 64 };
+
+      explicit contour_edges(contour_2 const & c)
+      {
+         size_t n = c.size();
+         std::vector<std::pair<point_2, point_2> > edges;
+         for (size_t pr = n - 1, cur = 0; cur != n; pr = cur++)
+         {
+            point_2 a = c[pr], b = c[cur];
+            if (a.y > b.y)
+               std::swap(a, b);
+            edges.push_back(std::make_pair(a, b));
+         }
+
+         std::sort(edges.begin(), edges.end(), [](std::pair<point_2, point_2> const & e1, std::pair<point_2, point_2> const & e2)
+         {
+            return e1.first.y < e2.first.y;
+         });
+
+         for (size_t l = 0; l != edges.size(); ++l)
+         {
+            ax.push_back(edges[l].first.x);
+            ay.push_back(edges[l].first.y);
+            bx.push_back(edges[l].second.x);
+            by.push_back(edges[l].second.y);
+            if (l % edge_block == 0)
+               top.push_back(by.back());
+            top.back() = std::max(top.back(), by.back());
+         }
+      }
+
+      size_t size() const
+      {
+         return ax.size();
+      }
+
+      bool contains(point_2 const & q) const
+      {
+         bool res;
+         contains(&q, 1, &res);
+         return res;
+      }
+
+      // contains for q[0], ..., q[n - 1], written to out
+      void contains(point_2 const * q, size_t n, bool * out) const
+      {
+         const size_t query_block = 16;
+
+         for (size_t qfirst = 0; qfirst < n; qfirst += query_block)
+         {
+            size_t qm = std::min(query_block, n - qfirst);
+            int64_t crossings[query_block] = {};
+            bool done[query_block] = {}, boundary[query_block] = {};
+
+            for (size_t block = 0; block != top.size(); ++block)
+            {
+               size_t efirst = block * edge_block, em = std::min<size_t>(edge_block, size() - efirst);
+               double const * pax = ax.data() + efirst, * pay = ay.data() + efirst;
+               double const * pbx = bx.data() + efirst, * pby = by.data() + efirst;
+
+               for (size_t k = 0; k < qm; ++k)
+               {
+                  double x = q[qfirst + k].x, y = q[qfirst + k].y;
+                  if (done[k] || y > top[block])
+                     continue;
+                  if (y < pay[0])
+                  {
+                     done[k] = true;
+                     continue;
+                  }
+
+                  int64_t crossed = 0, uncertain = 0;
+                  for (size_t l = 0; l < em; ++l)
+                  {
+                     double left = (pbx[l] - pax[l]) * (y - pay[l]);
+                     double right = (pby[l] - pay[l]) * (x - pax[l]);
+                     double res = left - right;
+                     double eps = (fabs(left) + fabs(right)) * 8 * std::numeric_limits<double>::epsilon();
+                     int64_t in_range = (y >= pay[l]) & (y <= pby[l]);
+                     crossed += in_range & (y < pby[l]) & (res > eps);
+                     uncertain += in_range & (res <= eps) & (res >= -eps);
+                  }
+                  crossings[k] += crossed;
+
+                  for (size_t l = 0; uncertain != 0 && l < em; ++l)
+                  {
+                     double left = (pbx[l] - pax[l]) * (y - pay[l]);
+                     double right = (pby[l] - pay[l]) * (x - pax[l]);
+                     double res = left - right;
+                     double eps = (fabs(left) + fabs(right)) * 8 * std::numeric_limits<double>::epsilon();
+                     if (y < pay[l] || y > pby[l] || res > eps || res < -eps)
+                        continue;
+
+                     --uncertain;
+                     int crossing = ray_crossing(point_2(pax[l], pay[l]), point_2(pbx[l], pby[l]), q[qfirst + k]);
+                     if (crossing == 2)
+                     {
+                        boundary[k] = done[k] = true;
+                        break;
+                     }
+                     crossings[k] += crossing;
+                  }
+               }
+            }
+
+            for (size_t k = 0; k < qm; ++k)
+               out[qfirst + k] = boundary[k] || crossings[k] % 2;
+         }
+      }
+
+   private:
+      std::vector<double> ax, ay, bx, by; // lower and upper ends of the edges, by the lower end
+      std::vector<double> top;            // highest upper end in each block
+   };
+
+   inline bool contains(contour_edges const & c, point_2 const & q)
+   {
+      return c.contains(q);
+   }
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cg/operations/contains/contour_point.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cg
+{
+   // contains(contour, point) prepared for many queries against one contour.
+   // A uniform grid over the bounding box, about cells_per_vertex cells per vertex, lists the edges
+   // touching each (closed) cell. A cell without edges is wholly inside or outside, which is stored.
+   // A point in a cell with edges walks its row to the nearest empty cell on the right: only the edges
+   // listed on the way can cross the ray between the point and that cell. The answers, boundary included,
+   // are those of contains for any contour; a query costs O(1) for contours spread evenly over their box.
+   struct contour_index
+   {
+      contour_index()
+         : nx_(0), ny_(0)
+      {}
+
+      explicit contour_index(contour_2 const & c, double cells_per_vertex = 2)
+         : pts_(c.begin(), c.end())
+      {
+         size_t n = pts_.size();
+         if (n == 0)
+         {
+            nx_ = ny_ = 0;
+            return;
+         }
+
+         double xmin = pts_[0].x, xmax = xmin, ymin = pts_[0].y, ymax = ymin;
+         for (point_2 const & p : pts_)
+         {
+            xmin = std::min(xmin, p.x);
+            xmax = std::max(xmax, p.x);
+            ymin = std::min(ymin, p.y);
+            ymax = std::max(ymax, p.y);
+         }
+
+         double w = xmax - xmin, h = ymax - ymin;
+         size_t cells = std::max<size_t>(1, size_t(n * cells_per_vertex));
+         nx_ = ny_ = 1;
+         if (w > 0 && h > 0)
+         {
+            nx_ = uint32_t(std::min<double>(cells, std::max(1., std::floor(std::sqrt(cells * (w / h)) + 0.5))));
+            ny_ = uint32_t(std::max<size_t>(1, cells / nx_));
+         }
+         else if (w > 0)
+            nx_ = uint32_t(cells);
+         else if (h > 0)
+            ny_ = uint32_t(cells);
+
+         xs_.resize(nx_ + 1);
+         ys_.resize(ny_ + 1);
+         for (uint32_t l = 0; l != nx_; ++l)
+            xs_[l] = xmin + w * l / nx_;
+         for (uint32_t l = 0; l != ny_; ++l)
+            ys_[l] = ymin + h * l / ny_;
+         xs_[nx_] = xmax;
+         ys_[ny_] = ymax;
+
+         fill_cells();
+         classify_empty_cells();
+      }
+
+      bool contains(point_2 const & p) const
+      {
+         if (pts_.empty() || !(p.x >= xs_.front() && p.x <= xs_.back() && p.y >= ys_.front() && p.y <= ys_.back()))
+            return false;
+
+         uint32_t r = slot(ys_, p.y), c = slot(xs_, p.x);
+         uint8_t s = state_[r * nx_ + c];
+         if (s != MIXED)
+            return s == INSIDE;
+
+         return walk(p, r, c);
+      }
+
+   private:
+      enum cell_state { OUTSIDE, INSIDE, MIXED };
+
+      struct entry
+      {
+         uint32_t edge;  // from pts_[edge] to the next vertex
+         uint32_t first; // leftmost column of the edge in this row
+      };
+
+      // cell of v in the bounds, closed on the right for the last one; v is within the bounds
+      static uint32_t slot(std::vector<double> const & bounds, double v)
+      {
+         uint32_t k = bounds.size() - 1;
+         double range = bounds[k] - bounds[0];
+         double t = range > 0 ? (v - bounds[0]) / range * k : 0;
+         uint32_t l = uint32_t(std::min<double>(k - 1, std::max(0., t)));
+         while (l > 0 && v < bounds[l])
+            --l;
+         while (l + 1 < k && v >= bounds[l + 1])
+            ++l;
+         return l;
+      }
+
+      point_2 const & from(uint32_t e) const { return pts_[e]; }
+      point_2 const & to(uint32_t e) const { return pts_[e + 1 == pts_.size() ? 0 : e + 1]; }
+
+      // cells touched by an edge, the x range in a row is widened by the interpolation error
+      template <class F>
+      void for_cells(uint32_t e, F f) const
+      {
+         point_2 const & a = from(e), & b = to(e);
+         double lo = std::min(a.y, b.y), hi = std::max(a.y, b.y);
+         uint32_t r0 = slot(ys_, lo), r1 = slot(ys_, hi);
+         while (r0 > 0 && ys_[r0] >= lo)
+            --r0;
+
+         double tol = 16 * std::numeric_limits<double>::epsilon() * (fabs(a.x) + fabs(b.x));
+         for (uint32_t r = r0; r <= r1; ++r)
+         {
+            double x0 = std::min(a.x, b.x), x1 = std::max(a.x, b.x);
+            if (a.y != b.y)
+            {
+               double y0 = std::max(lo, ys_[r]), y1 = std::min(hi, ys_[r + 1]);
+               double xa = a.x + (y0 - a.y) * (b.x - a.x) / (b.y - a.y);
+               double xb = a.x + (y1 - a.y) * (b.x - a.x) / (b.y - a.y);
+               x0 = std::max(x0, std::min(xa, xb) - tol);
+               x1 = std::min(x1, std::max(xa, xb) + tol);
+            }
+
+            uint32_t c0 = slot(xs_, x0), c1 = slot(xs_, x1);
+            while (c0 > 0 && xs_[c0] >= x0)
+               --c0;
+            for (uint32_t c = c0; c <= c1; ++c)
+               f(r * nx_ + c, entry{e, c0});
+         }
+      }
+
+      void fill_cells()
+      {
+         size_t cells = size_t(nx_) * ny_;
+         first_.assign(cells + 1, 0);
+         for (uint32_t e = 0; e != pts_.size(); ++e)
+            for_cells(e, [&](size_t cell, entry) { ++first_[cell + 1]; });
+         for (size_t l = 0; l != cells; ++l)
+            first_[l + 1] += first_[l];
+
+         entries_.resize(first_[cells]);
+         std::vector<uint32_t> fill(first_.begin(), first_.end() - 1);
+         for (uint32_t e = 0; e != pts_.size(); ++e)
+            for_cells(e, [&](size_t cell, entry en) { entries_[fill[cell]++] = en; });
+      }
+
+      // states of the empty cells right to left along each row, from the centre of each
+      void classify_empty_cells()
+      {
+         size_t cells = size_t(nx_) * ny_;
+         state_.assign(cells, MIXED);
+         next_empty_.assign(cells, nx_);
+         for (uint32_t r = 0; r != ny_; ++r)
+         {
+            for (uint32_t c = nx_; c-- != 0; )
+            {
+               size_t cell = r * nx_ + c;
+               if (c + 1 < nx_)
+                  next_empty_[cell] = first_[cell + 2] == first_[cell + 1] ? c + 1 : next_empty_[cell + 1];
+               if (first_[cell] != first_[cell + 1])
+                  continue;
+
+               point_2 centre((xs_[c] + xs_[c + 1]) / 2, (ys_[r] + ys_[r + 1]) / 2);
+               state_[cell] = walk(centre, r, c) ? INSIDE : OUTSIDE;
+            }
+         }
+      }
+
+      // p is in cell (r, c); q in the next empty cell at the height of p is on the same side of every edge
+      // not listed on the way, so the parity of p is that of q changed by the listed edges
+      bool walk(point_2 const & p, uint32_t r, uint32_t c) const
+      {
+         uint32_t t = next_empty_[r * nx_ + c];
+         bool bounded = t < nx_;
+         point_2 q(bounded ? (xs_[t] + xs_[t + 1]) / 2 : 0, p.y);
+         bool inside = bounded && state_[r * nx_ + t] == INSIDE;
+
+         for (uint32_t cc = c; cc != t; ++cc)
+         {
+            size_t cell = r * nx_ + cc;
+            for (uint32_t l = first_[cell]; l != first_[cell + 1]; ++l)
+            {
+               entry const & en = entries_[l];
+               // an edge is counted in the first cell of the walk listing it
+               if (cc != c && en.first != cc)
+                  continue;
+
+               int crossing = ray_crossing(from(en.edge), to(en.edge), p);
+               if (crossing == 2)
+                  return true;
+
+               inside ^= (crossing == 1);
+               if (bounded)
+                  inside ^= (ray_crossing(from(en.edge), to(en.edge), q) == 1);
+            }
+         }
+         return inside;
+      }
+
+      std::vector<point_2> pts_;
+      uint32_t nx_, ny_;
+      std::vector<double> xs_, ys_;     // cell bounds
+      std::vector<uint32_t> first_;     // entries of cell r * nx_ + c start at first_[r * nx_ + c]
+      std::vector<entry> entries_;
+      std::vector<uint8_t> state_;      // cell_state
+      std::vector<uint32_t> next_empty_; // column of the next empty cell to the right, nx_ when none
+   };
+
+   inline bool contains(contour_index const & index, point_2 const & p)
+   {
+      return index.contains(p);
+   }
+}
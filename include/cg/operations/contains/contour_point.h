@@ -40,6 +40,27 @@ namespace cg
       return cg::orientation(*(it - 1), *(it), q) != CG_RIGHT;
    }
 
+   // one edge of contains below: 2 when q is on the edge ab, 1 when ab crosses the ray from q to the right
+   // (an edge includes its lower end only, horizontal edges are never crossed), 0 otherwise
+   template<typename Scalar>
+   int ray_crossing(point_2t<Scalar> a, point_2t<Scalar> b, point_2t<Scalar> const & q)
+   {
+      if (a.y > b.y)
+         std::swap(a, b);
+
+      if (q.y < a.y || q.y > b.y)
+         return 0;
+
+      orientation_t orient = orientation(a, b, q);
+      if (orient == CG_COLLINEAR && std::min(a, b) <= q && q <= std::max(a, b))
+         return 2;
+
+      if (b.y <= q.y || a.y > q.y)
+         return 0;
+
+      return orient == CG_LEFT ? 1 : 0;
+   }
+
    // c is ordinary contour
    template<typename Scalar>
    bool contains(contour_2t<Scalar> const & a, point_2t<Scalar> const & b)
@@ -47,20 +68,11 @@ namespace cg
       size_t num_intersections = 0;
       for (size_t pr = a.vertices_num() - 1, cur = 0; cur != a.vertices_num(); pr = cur++)
       {
-         point_2t<Scalar> min_point = a[pr];
-         point_2t<Scalar> max_point = a[cur];
-         if (min_point.y > max_point.y)
-            std::swap(min_point, max_point);
-
-         orientation_t orient = orientation(min_point, max_point, b);
-         if (orient == CG_COLLINEAR && std::min(min_point, max_point) <= b && b <= std::max(min_point, max_point))
+         int crossing = ray_crossing(a[pr], a[cur], b);
+         if (crossing == 2)
             return true;
 
-         if (max_point.y <= b.y || min_point.y > b.y)
-            continue;
-
-         if (orient == CG_LEFT)
-            num_intersections++;
+         num_intersections += crossing;
       }
 
       return num_intersections % 2;
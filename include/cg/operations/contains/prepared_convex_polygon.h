@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cg/operations/contains/contour_point.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cg
+{
+   // convex_contains prepared for many queries against one convex contour (ccw orientation).
+   // The fan around c[0] is kept as the vectors c[2] - c[0], ..., c[n - 1] - c[0] in Eytzinger order
+   // (the implicit binary tree of the search, level by level) padded to a complete tree, so the lower_bound
+   // of convex_contains is a fixed number of steps down the tree reading neighbouring slots. A step takes
+   // the floating point filter of orientation; the queries it could not decide go through convex_contains.
+   // The batch contains descends the tree for a group of queries level by level, without branches,
+   // so the loads of different queries overlap.
+   struct prepared_convex_polygon
+   {
+      prepared_convex_polygon()
+         : depth_(0)
+      {}
+
+      explicit prepared_convex_polygon(contour_2 const & c)
+         : pts_(c)
+         , depth_(0)
+      {
+         if (pts_.size() < 3)
+            return;
+
+         size_t m = pts_.size() - 2;
+         while ((size_t(1) << depth_) - 1 < m)
+            ++depth_;
+
+         size_t slots = size_t(1) << depth_;
+         double nan = std::numeric_limits<double>::quiet_NaN();
+         fan_.assign(slots, point_2(nan, nan));
+         rank_.assign(slots, uint32_t(m));
+
+         size_t next = 0;
+         fill(1, next, m);
+      }
+
+      bool contains(point_2 const & q) const
+      {
+         bool res;
+         search<1>(&q, 1, &res);
+         return res;
+      }
+
+      // contains for q[0], ..., q[n - 1], written to out
+      void contains(point_2 const * q, size_t n, bool * out) const
+      {
+         search<8>(q, n, out);
+      }
+
+   private:
+      // queries in groups of group, descending together
+      template <size_t group>
+      void search(point_2 const * q, size_t n, bool * out) const
+      {
+         if (pts_.size() < 3)
+         {
+            for (size_t l = 0; l != n; ++l)
+               out[l] = convex_contains(pts_, q[l]);
+            return;
+         }
+
+         double const eps = 8 * std::numeric_limits<double>::epsilon();
+         point_2 const & o = pts_[0];
+
+         for (size_t first = 0; first < n; first += group)
+         {
+            size_t m = std::min(group, n - first);
+            double qx[group], qy[group];
+            uint32_t slot[group];
+            bool uncertain[group];
+
+            for (size_t k = 0; k != group; ++k)
+            {
+               point_2 const & p = q[first + std::min(k, m - 1)];
+               qx[k] = p.x - o.x;
+               qy[k] = p.y - o.y;
+               slot[k] = 1;
+               uncertain[k] = false;
+            }
+
+            // the descent goes right past the fan vectors with q to the left of them
+            for (uint32_t level = 0; level != depth_; ++level)
+            {
+               for (size_t k = 0; k != group; ++k)
+               {
+                  // the four slots two levels down share a cache line
+                  __builtin_prefetch(fan_.data() + 4 * slot[k]);
+                  double l = fan_[slot[k]].x * qy[k];
+                  double r = fan_[slot[k]].y * qx[k];
+                  double res = l - r;
+                  double bound = (fabs(l) + fabs(r)) * eps;
+                  uncertain[k] |= fabs(res) <= bound;
+                  slot[k] = 2 * slot[k] + (res > bound);
+               }
+            }
+
+            for (size_t k = 0; k != m; ++k)
+            {
+               point_2 const & p = q[first + k];
+               if (uncertain[k])
+               {
+                  out[first + k] = convex_contains(pts_, p);
+                  continue;
+               }
+
+               // the last step to the left of the descent is the lower_bound, none when only right steps
+               uint32_t s = slot[k] >> (__builtin_ctz(~slot[k]) + 1);
+               uint32_t r = s == 0 ? uint32_t(pts_.size() - 2) : rank_[s];
+               out[first + k] = r != pts_.size() - 2
+                             && orientation(o, pts_[1], p) != CG_RIGHT
+                             && orientation(pts_[r + 1], pts_[r + 2], p) != CG_RIGHT;
+            }
+         }
+      }
+
+      // in-order traversal of the tree from slot s takes the fan vectors in order, then the padding
+      void fill(size_t s, size_t & next, size_t m)
+      {
+         if (s >= fan_.size())
+            return;
+
+         fill(2 * s, next, m);
+         if (next < m)
+         {
+            fan_[s] = point_2(pts_[next + 2].x - pts_[0].x, pts_[next + 2].y - pts_[0].y);
+            rank_[s] = uint32_t(next);
+         }
+         ++next;
+         fill(2 * s + 1, next, m);
+      }
+
+      contour_2 pts_;
+      uint32_t depth_;             // levels of the tree, slots 1 .. 2^depth_ - 1
+      std::vector<point_2> fan_;    // fan vectors by slot, NaN in the padding
+      std::vector<uint32_t> rank_;  // position of the fan vector among c[2], ..., c[n - 1]
+   };
+
+   inline bool contains(prepared_convex_polygon const & c, point_2 const & q)
+   {
+      return c.contains(q);
+   }
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cg/primitives/contour.h>
+#include <cg/operations/orientation.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cg
+{
+namespace detail
+{
+   // drops repeated vertices and vertices in the middle of a straight run from the contour in [first, last)
+   // in place, starting from a corner; returns the new end, first when all the vertices are on a line
+   inline point_2 * drop_collinear(point_2 * first, point_2 * last)
+   {
+      last = std::unique(first, last);
+      while (last - first > 1 && *first == *(last - 1))
+         --last;
+
+      size_t n = last - first, corner = 0;
+      while (corner != n && orientation(first[(corner + n - 1) % n], first[corner], first[(corner + 1) % n]) == CG_COLLINEAR)
+         ++corner;
+      if (corner == n)
+         return first;
+
+      std::rotate(first, first + corner, last);
+      point_2 * res = first + 1;
+      for (size_t l = 1; l != n; ++l)
+         if (orientation(*(res - 1), first[l], first[(l + 1) % n]) != CG_COLLINEAR)
+            *res++ = first[l];
+      return res;
+   }
+
+   // crossing of the line pq with the segment st
+   inline point_2 line_crossing(point_2 const & p, point_2 const & q, point_2 const & s, point_2 const & t)
+   {
+      double ds = (q.x - p.x) * (s.y - p.y) - (q.y - p.y) * (s.x - p.x);
+      double dt = (q.x - p.x) * (t.y - p.y) - (q.y - p.y) * (t.x - p.x);
+      double f = ds / (ds - dt);
+      return point_2(s.x + (t.x - s.x) * f, s.y + (t.y - s.y) * f);
+   }
+
+   // convex_intersection breaks ties as if its second contour was moved by (e, e^2) for an infinitely
+   // small e > 0. Side of the point p from the moved line qr, when p is on qr:
+   // orientation(q + (e, e^2), r + (e, e^2), p) = (r.y - q.y) e - (r.x - q.x) e^2
+   inline orientation_t moved_line_side(point_2 const & q, point_2 const & r)
+   {
+      if (r.y != q.y)
+         return r.y > q.y ? CG_LEFT : CG_RIGHT;
+      return r.x < q.x ? CG_LEFT : CG_RIGHT;
+   }
+
+   // side of the moved point from pq, when the point is on pq:
+   // orientation(p, q, point + (e, e^2)) = (q.x - p.x) e^2 - (q.y - p.y) e
+   inline orientation_t moved_point_side(point_2 const & p, point_2 const & q)
+   {
+      if (q.y != p.y)
+         return q.y > p.y ? CG_RIGHT : CG_LEFT;
+      return q.x > p.x ? CG_LEFT : CG_RIGHT;
+   }
+}
+
+   // Intersection of convex contours a and b of ccw orientation in O(n + m) (O'Rourke). The current sides
+   // of a and b advance in turn, the one aiming at the line of the other going first, and the result is
+   // output from the first crossing of the boundaries around to it again: the vertices of the contour
+   // found inside since the last crossing, and the crossings. Ties are broken as if b was moved by an
+   // infinitely small generic vector, so no vertex of one contour is on a side of the other and sides only
+   // cross properly; contours which only touch have an intersection of no area, which is dropped.
+   // The vertices are written to out, which has room for a.size() + b.size() points, in ccw order and
+   // without repeated or collinear vertices; crossings are rounded to doubles. Returns the end of the
+   // vertices, out when the intersection has no area. Nothing is allocated.
+   inline point_2 * convex_intersection(contour_2 const & a, contour_2 const & b, point_2 * out)
+   {
+      size_t n = a.size(), m = b.size();
+      if (n < 3 || m < 3)
+         return out;
+
+      point_2 * res = out, * end = out + n + m;
+      auto emit = [&](point_2 const & p)
+      {
+         if (res != end && (res == out || *(res - 1) != p))
+            *res++ = p;
+      };
+
+      enum { unknown, a_inside, b_inside } inside = unknown;
+      size_t i = 0, j = 0, steps_a = 0, steps_b = 0, first_i = n, first_j = m;
+      do
+      {
+         // the current sides end at a[i] and b[j]
+         point_2 const & p1 = a[i == 0 ? n - 1 : i - 1], & p = a[i];
+         point_2 const & q1 = b[j == 0 ? m - 1 : j - 1], & q = b[j];
+
+         bool advance_a;
+         if (p1 == p || q1 == q)
+            advance_a = p1 == p;
+         else
+         {
+            orientation_t cross = edge_orientation(p1, p, q1, q);
+            orientation_t op = orientation(q1, q, p), oq = orientation(p1, p, q);
+            orientation_t p_side = op != CG_COLLINEAR ? op : detail::moved_line_side(q1, q);
+            orientation_t q_side = oq != CG_COLLINEAR ? oq : detail::moved_point_side(p1, p);
+
+            if (cross != CG_COLLINEAR)
+            {
+               orientation_t op1 = orientation(q1, q, p1), oq1 = orientation(p1, p, q1);
+               if ((op1 != CG_COLLINEAR ? op1 : detail::moved_line_side(q1, q)) != p_side
+                && (oq1 != CG_COLLINEAR ? oq1 : detail::moved_point_side(p1, p)) != q_side)
+               {
+                  if (i == first_i && j == first_j)
+                     break;
+                  if (first_i == n)
+                  {
+                     first_i = i;
+                     first_j = j;
+                     steps_a = steps_b = 0;
+                  }
+
+                  // the crossing is a vertex when one is on the line of the other
+                  if (op == CG_COLLINEAR)
+                     emit(p);
+                  else if (op1 == CG_COLLINEAR)
+                     emit(p1);
+                  else if (oq == CG_COLLINEAR)
+                     emit(q);
+                  else if (oq1 == CG_COLLINEAR)
+                     emit(q1);
+                  else
+                     emit(detail::line_crossing(q1, q, p1, p));
+
+                  inside = p_side == CG_LEFT ? a_inside : b_inside;
+               }
+            }
+            else if (p_side == CG_RIGHT && q_side == CG_RIGHT)
+            {
+               // parallel sides with each contour outside the other
+               return out;
+            }
+
+            advance_a = cross != CG_RIGHT ? q_side == CG_LEFT : p_side != CG_LEFT;
+         }
+
+         if (advance_a)
+         {
+            if (inside == a_inside)
+               emit(p);
+            i = i + 1 == n ? 0 : i + 1;
+            ++steps_a;
+         }
+         else
+         {
+            if (inside == b_inside)
+               emit(q);
+            j = j + 1 == m ? 0 : j + 1;
+            ++steps_b;
+         }
+      } while ((steps_a < n || steps_b < m) && steps_a < 2 * n && steps_b < 2 * m);
+
+      if (first_i == n)
+      {
+         // no crossing, one contour inside the other or none
+         bool a_in_b = true, b_in_a = true;
+         for (size_t l = 0; a_in_b && l != m; ++l)
+         {
+            point_2 const & q1 = b[l], & q = b[l + 1 == m ? 0 : l + 1];
+            orientation_t o = orientation(q1, q, a[0]);
+            a_in_b = q1 == q || (o != CG_COLLINEAR ? o : detail::moved_line_side(q1, q)) == CG_LEFT;
+         }
+         for (size_t l = 0; !a_in_b && b_in_a && l != n; ++l)
+         {
+            point_2 const & p1 = a[l], & p = a[l + 1 == n ? 0 : l + 1];
+            orientation_t o = orientation(p1, p, b[0]);
+            b_in_a = p1 == p || (o != CG_COLLINEAR ? o : detail::moved_point_side(p1, p)) == CG_LEFT;
+         }
+
+         if (a_in_b)
+            res = std::copy(a.begin(), a.end(), out);
+         else if (b_in_a)
+            res = std::copy(b.begin(), b.end(), out);
+         else
+            return out;
+      }
+
+      res = detail::drop_collinear(out, res);
+      return res - out < 3 ? out : res;
+   }
+
+   inline contour_2 convex_intersection(contour_2 const & a, contour_2 const & b)
+   {
+      std::vector<point_2> pts(a.size() + b.size());
+      pts.resize(convex_intersection(a, b, pts.data()) - pts.data());
+      return contour_2(pts);
+   }
+}
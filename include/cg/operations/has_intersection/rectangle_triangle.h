@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cg/primitives/rectangle.h>
+#include <cg/primitives/triangle.h>
+
+#include <cg/operations/has_intersection/triangle_segment.h>
+
+namespace cg
+{
+   template<class Scalar>
+   bool has_intersection(rectangle_2t<Scalar> const & r, triangle_2t<Scalar> const & t)
+   {
+      // t lies inside r, or a side of r meets t
+      if (r.contains(t[0]))
+         return true;
+
+      point_2t<Scalar> c[4] = { r.corner(0, 0), r.corner(1, 0), r.corner(1, 1), r.corner(0, 1) };
+      for (size_t l = 0, lp = 3; l != 4; lp = l++)
+         if (has_intersection(t, segment_2t<Scalar>(c[lp], c[l])))
+            return true;
+
+      return false;
+   }
+}
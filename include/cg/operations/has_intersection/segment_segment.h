@@ -4,11 +4,34 @@
 #include <cg/operations/contains/segment_point.h>
 #include <cg/operations/orientation.h>
 
+#include <algorithm>
+
 namespace cg
 {
+   // the bounding boxes of a and b are disjoint, an exact test on the coordinates
+   template<class Scalar>
+   bool disjoint_boxes(segment_2t<Scalar> const & a, segment_2t<Scalar> const & b)
+   {
+      return std::max(a[0].x, a[1].x) < std::min(b[0].x, b[1].x) || std::max(b[0].x, b[1].x) < std::min(a[0].x, a[1].x)
+          || std::max(a[0].y, a[1].y) < std::min(b[0].y, b[1].y) || std::max(b[0].y, b[1].y) < std::min(a[0].y, a[1].y);
+   }
+
+   // a and b are on one line
+   template<class Scalar>
+   bool collinear_overlap(segment_2t<Scalar> const & a, segment_2t<Scalar> const & b)
+   {
+      return (min(a) <= b[0] && max(a) >= b[0])
+         || (min(a) <= b[1] && max(a) >= b[1])
+         || (min(b) <= a[0] && max(b) >= a[0])
+         || (min(b) <= a[1] && max(b) >= a[1]);
+   }
+
    template<class Scalar>
    bool has_intersection(segment_2t<Scalar> const & a, segment_2t<Scalar> const & b)
    {
+      if (disjoint_boxes(a, b))
+         return false;
+
       if (a[0] == a[1])
          return contains(b, a[0]);
 
@@ -17,10 +40,7 @@ namespace cg
          ab[l] = orientation(a[0], a[1], b[l]);
 
       if (ab[0] == ab[1] && ab[0] == CG_COLLINEAR)
-         return (min(a) <= b[0] && max(a) >= b[0])
-            || (min(a) <= b[1] && max(a) >= b[1])
-            || (min(b) <= a[0] && max(b) >= a[0])
-            || (min(b) <= a[1] && max(b) >= a[1]);
+         return collinear_overlap(a, b);
 
       if (ab[0] == ab[1])
          return false;
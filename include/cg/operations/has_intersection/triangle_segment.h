@@ -6,17 +6,66 @@
 #include <cg/operations/contains/triangle_point.h>
 #include <cg/operations/has_intersection/segment_segment.h>
 
+#include <algorithm>
+
 namespace cg
 {
    template<class Scalar>
    bool has_intersection(triangle_2t<Scalar> const & t, segment_2t<Scalar> const & s)
    {
-      if (contains(t, s[0]))
-         return true;
+      if (std::max(s[0].x, s[1].x) < std::min({t[0].x, t[1].x, t[2].x}) || std::min(s[0].x, s[1].x) > std::max({t[0].x, t[1].x, t[2].x})
+       || std::max(s[0].y, s[1].y) < std::min({t[0].y, t[1].y, t[2].y}) || std::min(s[0].y, s[1].y) > std::max({t[0].y, t[1].y, t[2].y}))
+         return false;
+
+      orientation_t to = orientation(t[0], t[1], t[2]);
+      if (to == CG_COLLINEAR)
+      {
+         if (contains(t, s[0]))
+            return true;
+
+         for (size_t l = 0; l != 3; ++l)
+            if (has_intersection(t.side(l), s))
+               return true;
+
+         return false;
+      }
 
+      // the ends of s against the sides t[l] t[l + 1], shared by the containment and the side tests
+      orientation_t end[2][3];
+      for (size_t e = 0; e != 2; ++e)
+      {
+         bool inside = true;
+         for (size_t l = 0; l != 3; ++l)
+         {
+            end[e][l] = orientation(t[l], t[(l + 1) % 3], s[e]);
+            inside &= !opposite(end[e][l], to);
+         }
+         if (inside)
+            return true;
+      }
+
+      // the vertices against s, each shared by two sides
+      orientation_t vertex[3];
+      bool vertex_known[3] = {false, false, false};
       for (size_t l = 0; l != 3; ++l)
-         if (has_intersection(t.side(l), s))
+      {
+         if (end[0][l] == end[1][l])
+         {
+            if (end[0][l] == CG_COLLINEAR && collinear_overlap(segment_2t<Scalar>(t[l], t[(l + 1) % 3]), s))
+               return true;
+            continue;
+         }
+
+         for (size_t k = l; k != l + 2; ++k)
+            if (!vertex_known[k % 3])
+            {
+               vertex[k % 3] = orientation(s[0], s[1], t[k % 3]);
+               vertex_known[k % 3] = true;
+            }
+
+         if (vertex[l] != vertex[(l + 1) % 3])
             return true;
+      }
 
       return false;
    }
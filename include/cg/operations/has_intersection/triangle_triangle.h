@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cg/primitives/triangle.h>
+
+#include <cg/operations/contains/triangle_point.h>
+#include <cg/operations/has_intersection/triangle_segment.h>
+
+namespace cg
+{
+   template<class Scalar>
+   bool has_intersection(triangle_2t<Scalar> const & a, triangle_2t<Scalar> const & b)
+   {
+      // a side of b meets a, or a lies inside b
+      for (size_t l = 0; l != 3; ++l)
+         if (has_intersection(a, b.side(l)))
+            return true;
+
+      return contains(b, a[0]);
+   }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "cg/primitives/point.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <boost/numeric/interval.hpp>
+#include <gmpxx.h>
+
+#include <boost/optional.hpp>
+
+namespace cg
+{
+   // position of d relatively to the circle through counterclockwise a, b, c
+   // (for clockwise a, b, c inside and outside are swapped)
+   enum in_circle_t
+   {
+      CG_OUTSIDE = -1,
+      CG_COCIRCULAR = 0,
+      CG_INSIDE = 1
+   };
+
+   struct in_circle_d
+   {
+      boost::optional<in_circle_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         double adx = a.x - d.x, ady = a.y - d.y;
+         double bdx = b.x - d.x, bdy = b.y - d.y;
+         double cdx = c.x - d.x, cdy = c.y - d.y;
+
+         double bc = bdx * cdy - bdy * cdx, bc_abs = fabs(bdx * cdy) + fabs(bdy * cdx);
+         double ca = cdx * ady - cdy * adx, ca_abs = fabs(cdx * ady) + fabs(cdy * adx);
+         double ab = adx * bdy - ady * bdx, ab_abs = fabs(adx * bdy) + fabs(ady * bdx);
+
+         double alift = adx * adx + ady * ady;
+         double blift = bdx * bdx + bdy * bdy;
+         double clift = cdx * cdx + cdy * cdy;
+
+         double res = alift * bc + blift * ca + clift * ab;
+         double eps = (alift * bc_abs + blift * ca_abs + clift * ab_abs) * 16 * std::numeric_limits<double>::epsilon();
+
+         if (res > eps)
+            return CG_INSIDE;
+
+         if (res < -eps)
+            return CG_OUTSIDE;
+
+         return boost::none;
+      }
+   };
+
+   struct in_circle_i
+   {
+      boost::optional<in_circle_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
+
+         boost::numeric::interval<double>::traits_type::rounding _;
+         interval adx = interval(a.x) - d.x, ady = interval(a.y) - d.y;
+         interval bdx = interval(b.x) - d.x, bdy = interval(b.y) - d.y;
+         interval cdx = interval(c.x) - d.x, cdy = interval(c.y) - d.y;
+
+         interval res =   (square(adx) + square(ady)) * (bdx * cdy - bdy * cdx)
+                        + (square(bdx) + square(bdy)) * (cdx * ady - cdy * adx)
+                        + (square(cdx) + square(cdy)) * (adx * bdy - ady * bdx);
+
+         if (res.lower() > 0)
+            return CG_INSIDE;
+
+         if (res.upper() < 0)
+            return CG_OUTSIDE;
+
+         if (res.upper() == res.lower())
+            return CG_COCIRCULAR;
+
+         return boost::none;
+      }
+   };
+
+   struct in_circle_r
+   {
+      boost::optional<in_circle_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         mpq_class adx = mpq_class(a.x) - d.x, ady = mpq_class(a.y) - d.y;
+         mpq_class bdx = mpq_class(b.x) - d.x, bdy = mpq_class(b.y) - d.y;
+         mpq_class cdx = mpq_class(c.x) - d.x, cdy = mpq_class(c.y) - d.y;
+
+         mpq_class res =   (adx * adx + ady * ady) * (bdx * cdy - bdy * cdx)
+                         + (bdx * bdx + bdy * bdy) * (cdx * ady - cdy * adx)
+                         + (cdx * cdx + cdy * cdy) * (adx * bdy - ady * bdx);
+
+         int cres = cmp(res, 0);
+
+         if (cres > 0)
+            return CG_INSIDE;
+
+         if (cres < 0)
+            return CG_OUTSIDE;
+
+         return CG_COCIRCULAR;
+      }
+   };
+
+   inline in_circle_t in_circle(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
+   {
+      if (boost::optional<in_circle_t> v = in_circle_d()(a, b, c, d))
+         return *v;
+
+      if (boost::optional<in_circle_t> v = in_circle_i()(a, b, c, d))
+         return *v;
+
+      return *in_circle_r()(a, b, c, d);
+   }
+
+   // Positions of d[0], ..., d[n - 1] relatively to one circle through a, b, c, written to out.
+   // The floating point filter of in_circle_d runs as a flat loop over the queries, which the compiler
+   // vectorizes, and only the queries it could not decide go through in_circle_i and in_circle_r.
+   // Returns the number of such queries.
+   inline size_t in_circle(point_2 const & a, point_2 const & b, point_2 const & c,
+                           point_2 const * d, size_t n, in_circle_t * out)
+   {
+      const size_t block = 256;
+      int8_t sign[block];
+      size_t uncertain = 0;
+
+      for (size_t first = 0; first < n; first += block)
+      {
+         size_t m = std::min(block, n - first);
+         point_2 const * q = d + first;
+
+         for (size_t l = 0; l < m; ++l)
+         {
+            double adx = a.x - q[l].x, ady = a.y - q[l].y;
+            double bdx = b.x - q[l].x, bdy = b.y - q[l].y;
+            double cdx = c.x - q[l].x, cdy = c.y - q[l].y;
+
+            double bc = bdx * cdy - bdy * cdx, bc_abs = fabs(bdx * cdy) + fabs(bdy * cdx);
+            double ca = cdx * ady - cdy * adx, ca_abs = fabs(cdx * ady) + fabs(cdy * adx);
+            double ab = adx * bdy - ady * bdx, ab_abs = fabs(adx * bdy) + fabs(ady * bdx);
+
+            double alift = adx * adx + ady * ady;
+            double blift = bdx * bdx + bdy * bdy;
+            double clift = cdx * cdx + cdy * cdy;
+
+            double res = alift * bc + blift * ca + clift * ab;
+            double eps = (alift * bc_abs + blift * ca_abs + clift * ab_abs) * 16 * std::numeric_limits<double>::epsilon();
+
+            sign[l] = int8_t(res > eps) - int8_t(res < -eps);
+         }
+
+         for (size_t l = 0; l < m; ++l)
+         {
+            if (sign[l] != 0)
+            {
+               out[first + l] = in_circle_t(sign[l]);
+               continue;
+            }
+
+            ++uncertain;
+            if (boost::optional<in_circle_t> v = in_circle_i()(a, b, c, q[l]))
+               out[first + l] = *v;
+            else
+               out[first + l] = *in_circle_r()(a, b, c, q[l]);
+         }
+      }
+
+      return uncertain;
+   }
+
+   inline size_t in_circle(point_2 const & a, point_2 const & b, point_2 const & c,
+                           std::vector<point_2> const & d, std::vector<in_circle_t> & out)
+   {
+      out.resize(d.size());
+      return in_circle(a, b, c, d.data(), d.size(), out.data());
+   }
+}
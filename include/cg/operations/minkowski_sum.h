@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cg/primitives/contour.h>
+#include <cg/operations/orientation.h>
+
+#include <vector>
+
+namespace cg
+{
+namespace detail
+{
+   // lowest vertex of the contour, the leftmost of the lowest
+   inline size_t lowest_vertex(contour_2 const & c)
+   {
+      size_t res = 0;
+      for (size_t l = 1; l != c.size(); ++l)
+         if (c[l].y < c[res].y || (c[l].y == c[res].y && c[l].x < c[res].x))
+            res = l;
+      return res;
+   }
+
+   // whether the direction of pq is in [pi, 2 pi) from the x axis
+   inline bool lower_half(point_2 const & p, point_2 const & q)
+   {
+      return q.y < p.y || (q.y == p.y && q.x < p.x);
+   }
+
+   // whether the direction of the side p1 p comes no later than the one of q1 q, from the x axis ccw
+   inline bool direction_not_after(point_2 const & p1, point_2 const & p, point_2 const & q1, point_2 const & q)
+   {
+      bool hp = lower_half(p1, p), hq = lower_half(q1, q);
+      if (hp != hq)
+         return hq;
+      return edge_orientation(p1, p, q1, q) != CG_RIGHT;
+   }
+}
+
+   // Minkowski sum of convex contours a and b of ccw orientation in O(n + m). Both are walked from their
+   // lowest vertex, where the directions of the sides start from the x axis, merging the sides by direction;
+   // the sum is the contour of the vertex sums along the walk. Points and segments, as contours of one or
+   // two vertices, are convex here too. The vertices are written to out, which has room for
+   // a.size() + b.size() points, in ccw order and without repeated vertices; vertices in the middle of
+   // parallel sides are kept. Returns the end of the vertices, out when a or b is empty. Nothing is allocated.
+   inline point_2 * minkowski_sum(contour_2 const & a, contour_2 const & b, point_2 * out)
+   {
+      size_t n = a.size(), m = b.size();
+      if (n == 0 || m == 0)
+         return out;
+
+      size_t ia = detail::lowest_vertex(a), ib = detail::lowest_vertex(b);
+      point_2 * res = out;
+      auto emit = [&](point_2 const & p, point_2 const & q)
+      {
+         point_2 s(p.x + q.x, p.y + q.y);
+         if (res == out || *(res - 1) != s)
+            *res++ = s;
+      };
+
+      // i sides of a and j sides of b taken so far
+      size_t i = 0, j = 0;
+      emit(a[ia], b[ib]);
+      while (i + j != n + m)
+      {
+         point_2 const & p1 = a[(ia + i) % n], & p = a[(ia + i + 1) % n];
+         point_2 const & q1 = b[(ib + j) % m], & q = b[(ib + j + 1) % m];
+
+         // a side of no length has no direction and is taken at once
+         if (j == m || (i != n && (p1 == p || (q1 != q && detail::direction_not_after(p1, p, q1, q)))))
+            ++i;
+         else
+            ++j;
+
+         if (i + j != n + m)
+            emit(a[(ia + i) % n], b[(ib + j) % m]);
+      }
+
+      while (res - out > 1 && *out == *(res - 1))
+         --res;
+      return res;
+   }
+
+   inline contour_2 minkowski_sum(contour_2 const & a, contour_2 const & b)
+   {
+      std::vector<point_2> pts(a.size() + b.size());
+      pts.resize(minkowski_sum(a, b, pts.data()) - pts.data());
+      return contour_2(pts);
+   }
+}
@@ -96,6 +96,79 @@ namespace cg
       return *orientation_r()(a, b, c);
    }
 
+   // orientation of the vector cd relative to the vector ab, CG_LEFT when cd turns left from ab
+   struct edge_orientation_d
+   {
+      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         double l = (b.x - a.x) * (d.y - c.y);
+         double r = (b.y - a.y) * (d.x - c.x);
+         double res = l - r;
+         double eps = (fabs(l) + fabs(r)) * 8 * std::numeric_limits<double>::epsilon();
+
+         if (res > eps)
+            return CG_LEFT;
+
+         if (res < -eps)
+            return CG_RIGHT;
+
+         return boost::none;
+      }
+   };
+
+   struct edge_orientation_i
+   {
+      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
+
+         boost::numeric::interval<double>::traits_type::rounding _;
+         interval res =   (interval(b.x) - a.x) * (interval(d.y) - c.y)
+                        - (interval(b.y) - a.y) * (interval(d.x) - c.x);
+
+         if (res.lower() > 0)
+            return CG_LEFT;
+
+         if (res.upper() < 0)
+            return CG_RIGHT;
+
+         if (res.upper() == res.lower())
+            return CG_COLLINEAR;
+
+         return boost::none;
+      }
+   };
+
+   struct edge_orientation_r
+   {
+      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         mpq_class res =   (mpq_class(b.x) - a.x) * (mpq_class(d.y) - c.y)
+                         - (mpq_class(b.y) - a.y) * (mpq_class(d.x) - c.x);
+
+         int cres = cmp(res, 0);
+
+         if (cres > 0)
+            return CG_LEFT;
+
+         if (cres < 0)
+            return CG_RIGHT;
+
+         return CG_COLLINEAR;
+      }
+   };
+
+   inline orientation_t edge_orientation(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
+   {
+      if (boost::optional<orientation_t> v = edge_orientation_d()(a, b, c, d))
+         return *v;
+
+      if (boost::optional<orientation_t> v = edge_orientation_i()(a, b, c, d))
+         return *v;
+
+      return *edge_orientation_r()(a, b, c, d);
+   }
+
    inline bool counterclockwise(contour_2 const & c)
    {
       if (c.size() < 3) return true;
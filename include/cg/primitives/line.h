@@ -1,3 +1,5 @@
+#pragma once
+
 #include <cg/operations/orientation.h>
 #include <cg/operations/orientation_3d.h>
 
@@ -9,10 +11,6 @@ namespace cg {
 
         line() {}
 
-        line(const line & l)
-            : a(l.a), b(l.b), c(l.c)
-        {}
-
         line(double a, double b, double c)
             : a(a), b(b), c(c)
         {}
@@ -35,7 +33,340 @@ namespace cg {
         return !is_direct_vector_right(l);
     }
 
-    bool ray_line_intersection(const line & cross_line, const line & edge_line,
+    // Point given as the crossing of two lines, the lines are stored by value.
+    // The homogeneous coordinates (x : y : w) = l1 x l2 are computed once with bounds of their errors,
+    // the exact ones by exact(), only when a predicate can not decide by the approximation.
+    struct line_cross
+    {
+        struct exact_coords
+        {
+            mpq_class x, y, w;
+        };
+
+        line l1, l2;
+        double x, y, w;    // w > 0 up to its error
+        double ex, ey, ew; // bounds of the errors of x, y and w
+
+        line_cross()
+            : l1(0, 0, 0), l2(0, 0, 0), x(0), y(0), w(0), ex(0), ey(0), ew(0)
+        {}
+
+        line_cross(const line & line1, const line & line2)
+            : l1(line1), l2(line2)
+        {
+            double eps = 2 * std::numeric_limits<double>::epsilon();
+            x = l1.b * l2.c - l2.b * l1.c;
+            y = l2.a * l1.c - l1.a * l2.c;
+            w = l1.a * l2.b - l2.a * l1.b;
+            ex = (fabs(l1.b * l2.c) + fabs(l2.b * l1.c)) * eps;
+            ey = (fabs(l2.a * l1.c) + fabs(l1.a * l2.c)) * eps;
+            ew = (fabs(l1.a * l2.b) + fabs(l2.a * l1.b)) * eps;
+            if (w < -ew || (w <= ew && orientation_2d(l1.a, l1.b, l2.a, l2.b) == NEG_DEAD)) {
+                x = -x;
+                y = -y;
+                w = -w;
+            }
+        }
+
+        explicit line_cross(const point_2 & p)
+            : l1(1, 0, -p.x), l2(0, 1, -p.y)
+            , x(p.x), y(p.y), w(1), ex(0), ey(0), ew(0)
+        {}
+
+        // the same value as intersection_point<double>(l1, l2)
+        point_2 point() const
+        {
+            return point_2(x / w, y / w);
+        }
+
+        // computed on every call, only the rare exact stage of the predicates needs them
+        exact_coords exact() const
+        {
+            exact_coords res;
+            res.x = mpq_class(l1.b) * mpq_class(l2.c) - mpq_class(l2.b) * mpq_class(l1.c);
+            res.y = mpq_class(l2.a) * mpq_class(l1.c) - mpq_class(l1.a) * mpq_class(l2.c);
+            res.w = mpq_class(l1.a) * mpq_class(l2.b) - mpq_class(l2.a) * mpq_class(l1.b);
+            if (sgn(res.w) < 0) {
+                res.x = -res.x;
+                res.y = -res.y;
+                res.w = -res.w;
+            }
+            return res;
+        }
+    };
+
+
+    // Calls of the predicates on line crossings and how many of them went past the double filter
+    // to the interval stage and past that to the exact one. Counted per thread, reset by assigning.
+    struct line_predicate_stats
+    {
+        size_t calls, interval, exact;
+    };
+
+    inline line_predicate_stats & line_predicate_counters()
+    {
+        static thread_local line_predicate_stats stats = {0, 0, 0};
+        return stats;
+    }
+
+    namespace detail {
+        typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type line_interval;
+
+        // homogeneous coordinates of the crossing from its lines, false when the sign of w is not known,
+        // the caller sets the rounding mode
+        inline bool cross_intervals(const line_cross & p, line_interval & x, line_interval & y, line_interval & w)
+        {
+            typedef line_interval interval;
+            const line & l1 = p.l1, & l2 = p.l2;
+            x = interval(l1.b) * interval(l2.c) - interval(l2.b) * interval(l1.c);
+            y = interval(l2.a) * interval(l1.c) - interval(l1.a) * interval(l2.c);
+            w = interval(l1.a) * interval(l2.b) - interval(l2.a) * interval(l1.b);
+            if (w.upper() < 0) {
+                x = -x;
+                y = -y;
+                w = -w;
+            }
+            return w.lower() > 0;
+        }
+
+        // the same coefficients up to the sign, DCEL keeps reversed copies of its lines
+        inline bool same_line(const line & l, const line & m)
+        {
+            return (l.a == m.a && l.b == m.b && l.c == m.c) || (l.a == -m.a && l.b == -m.b && l.c == -m.c);
+        }
+
+        inline bool on_line(const line & l, const line_cross & p)
+        {
+            return same_line(l, p.l1) || same_line(l, p.l2);
+        }
+
+        // the same point when both are crossings of the same two lines
+        inline bool same_crossing(const line_cross & p, const line_cross & q)
+        {
+            return on_line(p.l1, q) && on_line(p.l2, q);
+        }
+
+        // crossings known to be collinear without computing: two coincide or all are on one line
+        inline bool trivially_collinear(const line_cross & a, const line_cross & b, const line_cross & c)
+        {
+            return same_crossing(a, b) || same_crossing(b, c) || same_crossing(a, c)
+                || (on_line(a.l1, b) && on_line(a.l1, c)) || (on_line(a.l2, b) && on_line(a.l2, c));
+        }
+
+        inline boost::optional<int> sign_d(double value, double err)
+        {
+            if (value > err)
+                return 1;
+
+            if (value < -err)
+                return -1;
+
+            return boost::none;
+        }
+
+        inline boost::optional<int> sign_i(const line_interval & value)
+        {
+            if (value.lower() > 0)
+                return 1;
+
+            if (value.upper() < 0)
+                return -1;
+
+            if (value.upper() == value.lower())
+                return 0;
+
+            return boost::none;
+        }
+
+        inline orientation_t to_orientation(int sign)
+        {
+            return sign > 0 ? CG_LEFT : (sign < 0 ? CG_RIGHT : CG_COLLINEAR);
+        }
+    }
+
+    // orientation of three crossings, CG_LEFT when they turn counterclockwise
+    struct turn_d
+    {
+        boost::optional<int> operator() (const line_cross & a, const line_cross & b, const line_cross & c) const
+        {
+            double res = a.x * (b.y * c.w - c.y * b.w) - a.y * (b.x * c.w - c.x * b.w) + a.w * (b.x * c.y - c.x * b.y);
+
+            // the determinant is multilinear, so the magnitudes with the errors added bound the propagated error
+            double m = fabs(a.x) * (fabs(b.y * c.w) + fabs(c.y * b.w)) + fabs(a.y) * (fabs(b.x * c.w) + fabs(c.x * b.w))
+                     + fabs(a.w) * (fabs(b.x * c.y) + fabs(c.x * b.y));
+            double ax = fabs(a.x) + a.ex, ay = fabs(a.y) + a.ey, aw = fabs(a.w) + a.ew;
+            double bx = fabs(b.x) + b.ex, by = fabs(b.y) + b.ey, bw = fabs(b.w) + b.ew;
+            double cx = fabs(c.x) + c.ex, cy = fabs(c.y) + c.ey, cw = fabs(c.w) + c.ew;
+            double me = ax * (by * cw + cy * bw) + ay * (bx * cw + cx * bw) + aw * (bx * cy + cx * by);
+
+            return detail::sign_d(res, (me - m) + 8 * std::numeric_limits<double>::epsilon() * me);
+        }
+    };
+
+    struct turn_i
+    {
+        boost::optional<int> operator() (const line_cross & a, const line_cross & b, const line_cross & c) const
+        {
+            if (detail::trivially_collinear(a, b, c))
+                return 0;
+
+            typedef detail::line_interval interval;
+            boost::numeric::interval<double>::traits_type::rounding _;
+
+            interval ax, ay, aw, bx, by, bw, cx, cy, cw;
+            if (!detail::cross_intervals(a, ax, ay, aw) || !detail::cross_intervals(b, bx, by, bw) || !detail::cross_intervals(c, cx, cy, cw))
+                return boost::none;
+
+            return detail::sign_i(ax * (by * cw - cy * bw) - ay * (bx * cw - cx * bw) + aw * (bx * cy - cx * by));
+        }
+    };
+
+    struct turn_r
+    {
+        boost::optional<int> operator() (const line_cross & a, const line_cross & b, const line_cross & c) const
+        {
+            const line_cross::exact_coords & p = a.exact(), & q = b.exact(), & r = c.exact();
+            mpq_class res = p.x * (q.y * r.w - r.y * q.w) - p.y * (q.x * r.w - r.x * q.w) + p.w * (q.x * r.y - r.x * q.y);
+            return sgn(res);
+        }
+    };
+
+    // sign of l at the crossing
+    struct line_point_sign_d
+    {
+        boost::optional<int> operator() (const line & l, const line_cross & p) const
+        {
+            double res = l.a * p.x + l.b * p.y + l.c * p.w;
+            double m = fabs(l.a * p.x) + fabs(l.b * p.y) + fabs(l.c * p.w);
+            double me = fabs(l.a) * (fabs(p.x) + p.ex) + fabs(l.b) * (fabs(p.y) + p.ey) + fabs(l.c) * (fabs(p.w) + p.ew);
+
+            return detail::sign_d(res, (me - m) + 8 * std::numeric_limits<double>::epsilon() * me);
+        }
+    };
+
+    struct line_point_sign_i
+    {
+        boost::optional<int> operator() (const line & l, const line_cross & p) const
+        {
+            if (detail::on_line(l, p))
+                return 0;
+
+            typedef detail::line_interval interval;
+            boost::numeric::interval<double>::traits_type::rounding _;
+
+            interval x, y, w;
+            if (!detail::cross_intervals(p, x, y, w))
+                return boost::none;
+
+            return detail::sign_i(interval(l.a) * x + interval(l.b) * y + interval(l.c) * w);
+        }
+    };
+
+    struct line_point_sign_r
+    {
+        boost::optional<int> operator() (const line & l, const line_cross & p) const
+        {
+            const line_cross::exact_coords & q = p.exact();
+            mpq_class res = mpq_class(l.a) * q.x + mpq_class(l.b) * q.y + mpq_class(l.c) * q.w;
+            return sgn(res);
+        }
+    };
+
+    // sign of p.x - q.x, or of p.y - q.y for by_y
+    struct coordinate_dif_d
+    {
+        bool by_y;
+
+        boost::optional<int> operator() (const line_cross & p, const line_cross & q) const
+        {
+            double pv = by_y ? p.y : p.x, pe = by_y ? p.ey : p.ex;
+            double qv = by_y ? q.y : q.x, qe = by_y ? q.ey : q.ex;
+
+            double res = pv * q.w - qv * p.w;
+            double m = fabs(pv * q.w) + fabs(qv * p.w);
+            double me = (fabs(pv) + pe) * (fabs(q.w) + q.ew) + (fabs(qv) + qe) * (fabs(p.w) + p.ew);
+
+            return detail::sign_d(res, (me - m) + 8 * std::numeric_limits<double>::epsilon() * me);
+        }
+    };
+
+    struct coordinate_dif_i
+    {
+        bool by_y;
+
+        boost::optional<int> operator() (const line_cross & p, const line_cross & q) const
+        {
+            // both on one vertical (horizontal) line
+            for (const line * l : {&p.l1, &p.l2}) {
+                if ((by_y ? l->a : l->b) == 0 && detail::on_line(*l, q))
+                    return 0;
+            }
+            if (detail::same_crossing(p, q))
+                return 0;
+
+            typedef detail::line_interval interval;
+            boost::numeric::interval<double>::traits_type::rounding _;
+
+            interval px, py, pw, qx, qy, qw;
+            if (!detail::cross_intervals(p, px, py, pw) || !detail::cross_intervals(q, qx, qy, qw))
+                return boost::none;
+
+            return detail::sign_i(by_y ? py * qw - qy * pw : px * qw - qx * pw);
+        }
+    };
+
+    struct coordinate_dif_r
+    {
+        bool by_y;
+
+        boost::optional<int> operator() (const line_cross & p, const line_cross & q) const
+        {
+            const line_cross::exact_coords & r = p.exact(), & s = q.exact();
+            mpq_class res = by_y ? mpq_class(r.y * s.w - s.y * r.w) : mpq_class(r.x * s.w - s.x * r.w);
+            return sgn(res);
+        }
+    };
+
+    namespace detail {
+        // runs the stages in turn, counting the calls that reach the later ones
+        template <class D, class I, class R, class... Args>
+        int staged_sign(const D & d, const I & i, const R & r, const Args & ... args)
+        {
+            line_predicate_stats & stats = line_predicate_counters();
+            stats.calls++;
+            if (boost::optional<int> v = d(args...))
+                return *v;
+
+            stats.interval++;
+            if (boost::optional<int> v = i(args...))
+                return *v;
+
+            stats.exact++;
+            return *r(args...);
+        }
+    }
+
+    inline orientation_t orientation(const line_cross & a, const line_cross & b, const line_cross & c)
+    {
+        return detail::to_orientation(detail::staged_sign(turn_d(), turn_i(), turn_r(), a, b, c));
+    }
+
+    inline dead_sign line_point_sign(const line & l, const line_cross & p)
+    {
+        return dead_sign(detail::staged_sign(line_point_sign_d(), line_point_sign_i(), line_point_sign_r(), l, p));
+    }
+
+    inline dead_sign x_dif(const line_cross & p, const line_cross & q)
+    {
+        return dead_sign(detail::staged_sign(coordinate_dif_d{false}, coordinate_dif_i{false}, coordinate_dif_r{false}, p, q));
+    }
+
+    inline dead_sign y_dif(const line_cross & p, const line_cross & q)
+    {
+        return dead_sign(detail::staged_sign(coordinate_dif_d{true}, coordinate_dif_i{true}, coordinate_dif_r{true}, p, q));
+    }
+
+    inline bool ray_line_intersection(const line & cross_line, const line & edge_line,
                                const line & sl1, const line & sl2)
     {
         line l = line(cross_line);
@@ -70,19 +401,13 @@ namespace cg {
         }
     }
 
-    int line_point_sign(const line & l, const line & sl1, const line & sl2)
+    // sign of l at the crossing of sl1 and sl2, the two are not parallel
+    inline int line_point_sign(const line & l, const line & sl1, const line & sl2)
     {
-        auto lp = point3d{l.a, l.b, l.c};
-        auto v1 = point3d{sl1.a, sl1.b, sl1.c};
-        auto v2 = point3d{sl2.a, sl2.b, sl2.c};
-
-        int vpos = orientation_3d(lp, v1, v2);
-        int vdet = orientation_2d(sl1.a, sl1.b, sl2.a, sl2.b);
-
-        return vpos * vdet;
+        return line_point_sign(l, line_cross(sl1, sl2));
     }
 
-    bool segment_line_intersection(const line & l,
+    inline bool segment_line_intersection(const line & l,
                                    const line & sl1, const line & sl2,
                                    const line & dl1, const line & dl2)
     {
@@ -99,14 +424,14 @@ namespace cg {
         return point_2t<Scalar>(x, y);
     }
 
-    dead_sign line_position(const line & un_line, const point_2 & p)
+    inline dead_sign line_position(const line & un_line, const point_2 & p)
     {
         line l = line(un_line);
         if (!is_normal_vector_up(l)) {
             l.inverse_vector();
         }
 
-        int res = line_point_sign(l, line{1, 0, -p.x}, line{0, 1, -p.y});
+        int res = line_point_sign(l, line_cross(p));
         switch (res) {
             case  1: return POS_DEAD; break;
             case  0: return ZERO_DEAD; break;
@@ -116,206 +441,31 @@ namespace cg {
         return ZERO_DEAD;
     }
 
-    orientation_t precise_turn_predicate(const line & l1, const line & l2,
+    // orientation of the crossings l1 x l2, s1 x s2 and t1 x t2, CG_LEFT when they turn counterclockwise
+    inline orientation_t precise_turn_predicate(const line & l1, const line & l2,
                                          const line & s1, const line & s2,
                                          const line & t1, const line & t2)
     {
-        double a11 = l1.a, b11 = l1.b, c11 = l1.c;
-        double a12 = l2.a, b12 = l2.b, c12 = l2.c;
-        double a21 = s1.a, b21 = s1.b, c21 = s1.c;
-        double a22 = s2.a, b22 = s2.b, c22 = s2.c;
-        double a31 = t1.a, b31 = t1.b, c31 = t1.c;
-        double a32 = t2.a, b32 = t2.b, c32 = t2.c;
-
-        int detl = orientation_2d(a11, b11, a12, b12);
-        int dets = orientation_2d(a21, b21, a22, b22);
-        int dett = orientation_2d(a31, b31, a32, b32);
-
-        int det_sign = detl * detl * dets * dett;
-
-        double p1x = -c11 * b12 + b11 * c12;
-        double p1y = -a11 * c12 + c11 * a12;
-        double p2x = -c21 * b22 + b21 * c22;
-        double p2y = -a21 * c22 + c21 * a22;
-        double p3x = -c31 * b32 + b31 * c32;
-        double p3y = -a31 * c32 + c31 * a32;
-
-        double det1 = a11 * b12 - b11 * a12;
-        double det2 = a21 * b22 - b21 * a22;
-        double det3 = a31 * b32 - b31 * a32;
-
-        double x1 = p2x * det1 - p1x * det2;
-        double x2 = p3y * det1 - p1y * det3;
-        double x3 = p2y * det1 - p1y * det2;
-        double x4 = p3x * det1 - p1x * det3;
-        double res_d = x1 * x2 - x3 * x4;
-        double eps = (fabs(x1 * x2) + fabs(x3 * x4)) * 45 * std::numeric_limits<double>::epsilon();
-
-        if (res_d > eps)
-            return (det_sign > 0 ? CG_LEFT : CG_RIGHT);
-
-        if (res_d < -eps)
-            return (det_sign > 0 ? CG_RIGHT : CG_LEFT);
-
-        typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
-        boost::numeric::interval<double>::traits_type::rounding _;
-
-        interval p1xi = interval(-c11) * interval(b12) + interval(b11) * interval(c12);
-        interval p1yi = interval(-a11) * interval(c12) + interval(c11) * interval(a12);
-        interval p2xi = interval(-c21) * interval(b22) + interval(b21) * interval(c22);
-        interval p2yi = interval(-a21) * interval(c22) + interval(c21) * interval(a22);
-        interval p3xi = interval(-c31) * interval(b32) + interval(b31) * interval(c32);
-        interval p3yi = interval(-a31) * interval(c32) + interval(c31) * interval(a32);
-
-        interval det1i = interval(a11) * interval(b12) - interval(b11) * interval(a12);
-        interval det2i = interval(a21) * interval(b22) - interval(b21) * interval(a22);
-        interval det3i = interval(a31) * interval(b32) - interval(b31) * interval(a32);
-
-        interval x1i = p2xi * det1i - p1xi * det2i;
-        interval x2i = p3yi * det1i - p1yi * det3i;
-        interval x3i = p2yi * det1i - p1yi * det2i;
-        interval x4i = p3xi * det1i - p1xi * det3i;
-        interval res_i = x1i * x2i - x3i * x4i;
-
-        if (res_i.lower() > 0)
-            return (det_sign > 0 ? CG_LEFT : CG_RIGHT);
-
-        if (res_i.upper() < 0)
-            return (det_sign > 0 ? CG_RIGHT : CG_LEFT);
-
-        if (res_i.upper() == res_i.lower())
-            return CG_COLLINEAR;
-
-        mpq_class p1xr = mpq_class(-c11) * mpq_class(b12) + mpq_class(b11) * mpq_class(c12);
-        mpq_class p1yr = mpq_class(-a11) * mpq_class(c12) + mpq_class(c11) * mpq_class(a12);
-        mpq_class p2xr = mpq_class(-c21) * mpq_class(b22) + mpq_class(b21) * mpq_class(c22);
-        mpq_class p2yr = mpq_class(-a21) * mpq_class(c22) + mpq_class(c21) * mpq_class(a22);
-        mpq_class p3xr = mpq_class(-c31) * mpq_class(b32) + mpq_class(b31) * mpq_class(c32);
-        mpq_class p3yr = mpq_class(-a31) * mpq_class(c32) + mpq_class(c31) * mpq_class(a32);
-
-        mpq_class det1r = mpq_class(a11) * mpq_class(b12) - mpq_class(b11) * mpq_class(a12);
-        mpq_class det2r = mpq_class(a21) * mpq_class(b22) - mpq_class(b21) * mpq_class(a22);
-        mpq_class det3r = mpq_class(a31) * mpq_class(b32) - mpq_class(b31) * mpq_class(a32);
-
-        mpq_class x1r = p2xr * det1r - p1xr * det2r;
-        mpq_class x2r = p3yr * det1r - p1yr * det3r;
-        mpq_class x3r = p2yr * det1r - p1yr * det2r;
-        mpq_class x4r = p3xr * det1r - p1xr * det3r;
-        mpq_class res_r = x1r * x2r - x3r * x4r;
-
-        int cres = cmp(res_r, 0);
-
-        if (cres > 0)
-           return (det_sign > 0 ? CG_LEFT : CG_RIGHT);
-
-        if (cres < 0)
-           return (det_sign > 0 ? CG_RIGHT : CG_LEFT);
-
-        return CG_COLLINEAR;
+        return orientation(line_cross(l1, l2), line_cross(s1, s2), line_cross(t1, t2));
     }
 
-    orientation_t point_segment_orientation(const line & sl1, const line & sl2,
+    inline orientation_t point_segment_orientation(const line & sl1, const line & sl2,
                                             const line & dl1, const line & dl2,
                                             const point_2 & c)
     {
-        return precise_turn_predicate(sl1, sl2, dl1, dl2, line{1, 0, -c.x}, line{0, 1, -c.y});
+        return orientation(line_cross(sl1, sl2), line_cross(dl1, dl2), line_cross(c));
     }
 
-    dead_sign x_dif(const line & l1, const line & l2,
+    // sign of the difference of the x coordinates of the crossings l1 x l2 and s1 x s2
+    inline dead_sign x_dif(const line & l1, const line & l2,
                     const line & s1, const line & s2)
     {
-        int det_ls = orientation_2d(l1.a, l1.b, l2.a, l2.b) * orientation_2d(s1.a, s1.b, s2.a, s2.b);
-
-        double det1 = -l1.c * l2.b + l1.b * l2.c;
-        double det2 = s1.a * s2.b - s1.b * s2.a;
-        double det3 = -s1.c * s2.b + s1.b * s2.c;
-        double det4 = l1.a * l2.b - l1.b * l2.a;
-
-        double res_d = det1 * det2 - det3 * det4;
-        double eps = (fabs(det1 * det2) + fabs(det3 * det4)) * 18 * std::numeric_limits<double>::epsilon();
-
-        if (res_d > eps)
-            return (det_ls > 0 ? POS_DEAD : NEG_DEAD);
-
-        if (res_d < -eps)
-            return (det_ls > 0 ? NEG_DEAD : POS_DEAD);
-
-        typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
-        boost::numeric::interval<double>::traits_type::rounding _;
-
-        interval res_i = (interval(-l1.c) * interval(l2.b) + interval(l1.b) * interval(l2.c))
-                       * (interval(s1.a) * interval(s2.b) - interval(s1.b) * interval(s2.a))
-                       - (interval(-s1.c) * interval(s2.b) + interval(s1.b) * interval(s2.c))
-                       * (interval(l1.a) * interval(l2.b) - interval(l1.b) * interval(l2.a));
-
-        if (res_i.lower() > 0)
-            return (det_ls > 0 ? POS_DEAD : NEG_DEAD);
-
-        if (res_i.upper() < 0)
-            return (det_ls > 0 ? NEG_DEAD : POS_DEAD);
-
-        mpq_class res_r = (mpq_class(-l1.c) * mpq_class(l2.b) + mpq_class(l1.b) * mpq_class(l2.c))
-                        * (mpq_class(s1.a) * mpq_class(s2.b) - mpq_class(s1.b) * mpq_class(s2.a))
-                        - (mpq_class(-s1.c) * mpq_class(s2.b) + mpq_class(s1.b) * mpq_class(s2.c))
-                        * (mpq_class(l1.a) * mpq_class(l2.b) - mpq_class(l1.b) * mpq_class(l2.a));
-
-        int cres = cmp(res_r, 0);
-
-        if (cres > 0)
-           return (det_ls > 0 ? POS_DEAD : NEG_DEAD);
-
-        if (cres < 0)
-           return (det_ls > 0 ? NEG_DEAD : POS_DEAD);
-
-        return ZERO_DEAD;
+        return x_dif(line_cross(l1, l2), line_cross(s1, s2));
     }
 
-    /*dead_sign y_dif(const line & l1, const line & l2,
+    inline dead_sign y_dif(const line & l1, const line & l2,
                     const line & s1, const line & s2)
     {
-        int det_ls = orientation_2d(l1.a, l1.b, l2.a, l2.b) * orientation_2d(s1.a, s1.b, s2.a, s2.b);
-
-        double det1 = -l1.a * l2.c + l1.c * l2.a;
-        double det2 = s1.a * s2.b - s1.b * s2.a;
-        double det3 = -s1.a * s2.c + s1.c * s2.a;
-        double det4 = l1.a * l2.b - l1.b * l2.a;
-
-        double res_d = det1 * det2 - det3 * det4;
-        double eps = (fabs(det1 * det2) + fabs(det3 * det4)) * 18 * std::numeric_limits<double>::epsilon();
-
-        if (res_d > eps)
-            return (det_ls > 0 ? POS_DEAD : NEG_DEAD);
-
-        if (res_d < -eps)
-            return (det_ls > 0 ? NEG_DEAD : POS_DEAD);
-
-        typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
-        boost::numeric::interval<double>::traits_type::rounding _;
-
-        interval res_i = (interval(-l1.a) * interval(l2.c) + interval(l1.c) * interval(l2.a))
-                       * (interval(s1.a) * interval(s2.b) - interval(s1.b) * interval(s2.a))
-                       - (interval(-s1.a) * interval(s2.c) + interval(s1.c) * interval(s2.a))
-                       * (interval(l1.a) * interval(l2.b) - interval(l1.b) * interval(l2.a));
-
-        if (res_i.lower() > 0)
-            return (det_ls > 0 ? POS_DEAD : NEG_DEAD);
-
-        if (res_i.upper() < 0)
-            return (det_ls > 0 ? NEG_DEAD : POS_DEAD);
-
-        mpq_class res_r = (mpq_class(-l1.a) * mpq_class(l2.c) + mpq_class(l1.c) * mpq_class(l2.a))
-                        * (mpq_class(s1.a) * mpq_class(s2.b) - mpq_class(s1.b) * mpq_class(s2.a))
-                        - (mpq_class(-s1.a) * mpq_class(s2.c) + mpq_class(s1.c) * mpq_class(s2.a))
-                        * (mpq_class(l1.a) * mpq_class(l2.b) - mpq_class(l1.b) * mpq_class(l2.a));
-
-        int cres = cmp(res_r, 0);
-
-        if (cres > 0)
-           return (det_ls > 0 ? POS_DEAD : NEG_DEAD);
-
-        if (cres < 0)
-           return (det_ls > 0 ? NEG_DEAD : POS_DEAD);
-
-        return ZERO_DEAD;
-    }*/
+        return y_dif(line_cross(l1, l2), line_cross(s1, s2));
+    }
 }
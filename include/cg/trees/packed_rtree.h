@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cg/primitives/rectangle.h>
+#include <cg/primitives/segment.h>
+#include <cg/primitives/triangle.h>
+
+#include <cg/operations/has_intersection/segment_segment.h>
+#include <cg/operations/has_intersection/rectangle_segment.h>
+#include <cg/operations/has_intersection/triangle_segment.h>
+#include <cg/operations/has_intersection/rectangle_triangle.h>
+#include <cg/operations/has_intersection/triangle_triangle.h>
+
+#include <cg/common/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace cg
+{
+   inline rectangle_2 bounding_box(rectangle_2 const & r)
+   {
+      return r;
+   }
+
+   inline rectangle_2 bounding_box(segment_2 const & s)
+   {
+      return rectangle_2(range(std::min(s[0].x, s[1].x), std::max(s[0].x, s[1].x)),
+                         range(std::min(s[0].y, s[1].y), std::max(s[0].y, s[1].y)));
+   }
+
+   inline rectangle_2 bounding_box(triangle_2 const & t)
+   {
+      return rectangle_2(range(std::min({t[0].x, t[1].x, t[2].x}), std::max({t[0].x, t[1].x, t[2].x})),
+                         range(std::min({t[0].y, t[1].y, t[2].y}), std::max({t[0].y, t[1].y, t[2].y})));
+   }
+
+namespace detail
+{
+   // exact test of a query against a primitive of the tree
+   inline bool rtree_hit(rectangle_2 const & q, segment_2 const & s) { return has_intersection(q, s); }
+   inline bool rtree_hit(segment_2 const & q, segment_2 const & s)   { return has_intersection(q, s); }
+   inline bool rtree_hit(triangle_2 const & q, segment_2 const & s)  { return has_intersection(q, s); }
+   inline bool rtree_hit(rectangle_2 const & q, triangle_2 const & t) { return has_intersection(q, t); }
+   inline bool rtree_hit(segment_2 const & q, triangle_2 const & t)   { return has_intersection(t, q); }
+   inline bool rtree_hit(triangle_2 const & q, triangle_2 const & t)  { return has_intersection(q, t); }
+}
+
+   // Static R-tree over segments or triangles, bulk loaded bottom up by sort-tile-recursive: the boxes of
+   // a level are sorted by the x of their centres, cut into about sqrt(nodes) vertical slabs, each slab
+   // sorted by y and cut into nodes of up to fanout boxes. The sorts run in parallel. Every level is kept
+   // as separate arrays of box coordinates with the range of children of each node in the level below,
+   // so a node tests its children in one flat loop. Queries go down the boxes overlapping the box of the
+   // query and report the primitives whose exact has_intersection with the query holds.
+   template <class Primitive>
+   class packed_rtree
+   {
+   public:
+      enum { fanout = 16 };
+
+      packed_rtree() {}
+
+      explicit packed_rtree(std::vector<Primitive> const & primitives, size_t threads = 0)
+         : primitives_(primitives)
+      {
+         size_t n = primitives.size();
+         if (n == 0)
+            return;
+
+         level items;
+         items.resize(n);
+         common::parallel_for(n, 1 << 14, [&](size_t first, size_t last)
+         {
+            for (size_t l = first; l != last; ++l)
+            {
+               rectangle_2 box = bounding_box(primitives[l]);
+               items.xmin[l] = box.x.inf;
+               items.xmax[l] = box.x.sup;
+               items.ymin[l] = box.y.inf;
+               items.ymax[l] = box.y.sup;
+               items.begin[l] = uint32_t(l);
+            }
+         }, threads);
+
+         // the items are the level below the leaves, begin holding the primitive
+         levels_.push_back(std::move(items));
+         while (levels_.back().size() > fanout || levels_.size() == 1)
+         {
+            level & below = levels_.back();
+            below.permute(str_order(below, threads), threads);
+            levels_.push_back(group(below, threads));
+         }
+      }
+
+      size_t size() const
+      {
+         return primitives_.size();
+      }
+
+      // f(i) for the primitives i having an intersection with q, which is a rectangle_2, segment_2 or triangle_2
+      template <class Query, class F>
+      void query(Query const & q, F f) const
+      {
+         if (primitives_.empty())
+            return;
+
+         rectangle_2 box = bounding_box(q);
+         std::pair<uint32_t, uint32_t> stack[max_levels * fanout];
+         size_t top = 0;
+
+         uint32_t root = uint32_t(levels_.size() - 1);
+         for (uint32_t k = 0; k != levels_[root].size(); ++k)
+            if (levels_[root].overlaps(k, box))
+               stack[top++] = std::make_pair(root, k);
+
+         while (top != 0)
+         {
+            std::pair<uint32_t, uint32_t> node = stack[--top];
+            level const & own = levels_[node.first], & below = levels_[node.first - 1];
+            uint32_t first = own.begin[node.second], last = own.end[node.second];
+
+            if (node.first == 1)
+            {
+               for (uint32_t c = first; c != last; ++c)
+                  if (below.overlaps(c, box) && detail::rtree_hit(q, primitives_[below.begin[c]]))
+                     f(size_t(below.begin[c]));
+               continue;
+            }
+
+            for (uint32_t c = first; c != last; ++c)
+               if (below.overlaps(c, box))
+                  stack[top++] = std::make_pair(node.first - 1, c);
+         }
+      }
+
+      // the primitives hit by queries[k] are hits[first[k]], ..., hits[first[k + 1] - 1];
+      // the queries are spread over the threads
+      template <class Query>
+      void query(std::vector<Query> const & queries, std::vector<uint32_t> & first, std::vector<uint32_t> & hits,
+                 size_t threads = 0) const
+      {
+         size_t n = queries.size(), grain = 256;
+         std::vector<std::vector<uint32_t> > chunk_hits((n + grain - 1) / grain);
+         first.assign(n + 1, 0);
+
+         common::parallel_for(n, grain, [&](size_t lo, size_t hi)
+         {
+            std::vector<uint32_t> & out = chunk_hits[lo / grain];
+            for (size_t k = lo; k != hi; ++k)
+            {
+               size_t before = out.size();
+               query(queries[k], [&out](size_t i) { out.push_back(uint32_t(i)); });
+               first[k + 1] = uint32_t(out.size() - before);
+            }
+         }, threads);
+
+         for (size_t k = 0; k != n; ++k)
+            first[k + 1] += first[k];
+
+         hits.resize(first[n]);
+         common::parallel_for(chunk_hits.size(), 1, [&](size_t lo, size_t hi)
+         {
+            for (size_t c = lo; c != hi; ++c)
+               std::copy(chunk_hits[c].begin(), chunk_hits[c].end(), hits.begin() + first[c * grain]);
+         }, threads);
+      }
+
+   private:
+      enum { max_levels = 16 };
+
+      struct level
+      {
+         std::vector<double> xmin, ymin, xmax, ymax;
+         std::vector<uint32_t> begin, end; // children in the level below, the primitive for the items
+
+         size_t size() const
+         {
+            return xmin.size();
+         }
+
+         void resize(size_t n)
+         {
+            xmin.resize(n);
+            ymin.resize(n);
+            xmax.resize(n);
+            ymax.resize(n);
+            begin.resize(n);
+            end.resize(n);
+         }
+
+         bool overlaps(uint32_t k, rectangle_2 const & box) const
+         {
+            return (xmin[k] <= box.x.sup) & (xmax[k] >= box.x.inf) & (ymin[k] <= box.y.sup) & (ymax[k] >= box.y.inf);
+         }
+
+         void permute(std::vector<uint32_t> const & order, size_t threads)
+         {
+            level res;
+            res.resize(order.size());
+            common::parallel_for(order.size(), 1 << 14, [&](size_t first, size_t last)
+            {
+               for (size_t l = first; l != last; ++l)
+               {
+                  uint32_t k = order[l];
+                  res.xmin[l] = xmin[k];
+                  res.ymin[l] = ymin[k];
+                  res.xmax[l] = xmax[k];
+                  res.ymax[l] = ymax[k];
+                  res.begin[l] = begin[k];
+                  res.end[l] = end[k];
+               }
+            }, threads);
+            *this = std::move(res);
+         }
+      };
+
+      // sort-tile-recursive order of the boxes of a level
+      static std::vector<uint32_t> str_order(level const & lv, size_t threads)
+      {
+         size_t n = lv.size();
+         std::vector<uint32_t> order(n);
+         std::iota(order.begin(), order.end(), 0);
+
+         common::parallel_sort(order.begin(), order.end(), [&lv](uint32_t a, uint32_t b)
+         {
+            return lv.xmin[a] + lv.xmax[a] < lv.xmin[b] + lv.xmax[b];
+         }, threads);
+
+         size_t nodes = (n + fanout - 1) / fanout;
+         size_t slab = size_t(std::ceil(std::sqrt(double(nodes)))) * fanout;
+         common::parallel_for((n + slab - 1) / slab, 1, [&](size_t first, size_t last)
+         {
+            for (size_t s = first; s != last; ++s)
+               std::sort(order.begin() + s * slab, order.begin() + std::min(n, (s + 1) * slab), [&lv](uint32_t a, uint32_t b)
+               {
+                  return lv.ymin[a] + lv.ymax[a] < lv.ymin[b] + lv.ymax[b];
+               });
+         }, threads);
+
+         return order;
+      }
+
+      // nodes over consecutive runs of fanout boxes
+      static level group(level const & below, size_t threads)
+      {
+         size_t n = (below.size() + fanout - 1) / fanout;
+         level res;
+         res.resize(n);
+         common::parallel_for(n, 1 << 12, [&](size_t lo, size_t hi)
+         {
+            for (size_t k = lo; k != hi; ++k)
+            {
+               uint32_t first = uint32_t(k * fanout), last = uint32_t(std::min(below.size(), (k + 1) * fanout));
+               res.begin[k] = first;
+               res.end[k] = last;
+               res.xmin[k] = *std::min_element(below.xmin.begin() + first, below.xmin.begin() + last);
+               res.ymin[k] = *std::min_element(below.ymin.begin() + first, below.ymin.begin() + last);
+               res.xmax[k] = *std::max_element(below.xmax.begin() + first, below.xmax.begin() + last);
+               res.ymax[k] = *std::max_element(below.ymax.begin() + first, below.ymax.begin() + last);
+            }
+         }, threads);
+         return res;
+      }
+
+      std::vector<Primitive> primitives_;
+      std::vector<level> levels_; // levels_[0] are the primitive boxes, the last level the roots
+   };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <cstdint>
+#include <cg/primitives/contour.h>
+#include <cg/triangulation/triangle_mesh.h>
+#include <cg/triangulation/triangulation.h>
+#include <cg/common/parallel.h>
+
+namespace cg {
+   // Triangulations of independent polygons stored one after another in a single mesh.
+   // Polygon i owns vertices [vertex_offsets[i], vertex_offsets[i + 1]) (its contours concatenated)
+   // and triangles [triangle_offsets[i], triangle_offsets[i + 1]), triangle indices are into the whole mesh.
+   struct triangle_mesh_batch {
+      triangle_mesh mesh;
+      std::vector<uint32_t> vertex_offsets, triangle_offsets;
+
+      size_t size() const {
+         return vertex_offsets.empty() ? 0 : vertex_offsets.size() - 1;
+      }
+
+      void clear() {
+         mesh.clear();
+         vertex_offsets.clear();
+         triangle_offsets.clear();
+      }
+   };
+
+   // Triangulates every polygon of the list on `threads` threads (0 means one per core).
+   // Polygons are handed out in small chunks through a shared counter, so threads that got cheap
+   // polygons take more of them. Each polygon gets its room for n + 2k - 4 triangles up front and
+   // the output is compacted afterwards in the rare case a degenerate polygon produced fewer.
+   inline void triangulate(const std::vector<std::vector<contour_2>> &polygons, triangle_mesh_batch &batch,
+         size_t threads = 0) {
+      size_t count = polygons.size();
+      batch.clear();
+      batch.vertex_offsets.resize(count + 1);
+      batch.triangle_offsets.resize(count + 1);
+
+      // vertex offsets and the triangle room of every polygon
+      std::vector<uint32_t> room(count + 1);
+      batch.vertex_offsets[0] = room[0] = 0;
+      for (size_t i = 0; i < count; i++) {
+         size_t n = 0;
+         for (const contour_2 &c : polygons[i]) n += c.size();
+         size_t bound = n + 2 * polygons[i].size();
+         batch.vertex_offsets[i + 1] = batch.vertex_offsets[i] + n;
+         room[i + 1] = room[i] + (bound > 4 ? bound - 4 : 0);
+      }
+      batch.mesh.vertices.resize(batch.vertex_offsets[count]);
+      batch.mesh.triangles.resize(3 * size_t(room[count]));
+
+      if (threads == 0) threads = common::hardware_threads();
+      size_t grain = std::max<size_t>(1, std::min<size_t>(256, count / (8 * threads)));
+      std::vector<uint32_t> &made = batch.triangle_offsets;
+      common::parallel_for(count, grain, [&](size_t first, size_t last) {
+         triangulation_sweep sweep;
+         std::vector<uint32_t> triangles;
+         for (size_t i = first; i != last; i++) {
+            uint32_t base = batch.vertex_offsets[i];
+            sweep.run(polygons[i], triangles);
+            std::copy(sweep.pts.begin(), sweep.pts.end(), batch.mesh.vertices.begin() + base);
+
+            assert(triangles.size() <= 3 * size_t(room[i + 1] - room[i]));
+            uint32_t *out = batch.mesh.triangles.data() + 3 * size_t(room[i]);
+            for (uint32_t v : triangles) *out++ = base + v;
+            made[i + 1] = triangles.size() / 3;
+         }
+      }, threads);
+
+      // turn the counts into offsets, moving triangles down where a polygon used less than its room
+      made[0] = 0;
+      for (size_t i = 0; i < count; i++) {
+         uint32_t from = room[i], num = made[i + 1];
+         made[i + 1] = made[i] + num;
+         if (made[i] == from) continue;
+         std::copy(batch.mesh.triangles.begin() + 3 * size_t(from), batch.mesh.triangles.begin() + 3 * size_t(from + num),
+               batch.mesh.triangles.begin() + 3 * size_t(made[i]));
+      }
+      batch.mesh.triangles.resize(3 * size_t(made[count]));
+   }
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cg/primitives/point.h>
+#include <cg/operations/orientation.h>
+#include <cg/operations/in_circle.h>
+#include <cg/triangulation/triangle_mesh.h>
+#include <cg/common/parallel.h>
+
+namespace cg {
+   // index of (x, y) along the Hilbert curve filling the 2^order x 2^order grid
+   inline uint64_t hilbert_index(uint32_t x, uint32_t y, int order = 16) {
+      uint32_t n = uint32_t(1) << order;
+      uint64_t d = 0;
+      for (uint32_t s = n / 2; s > 0; s /= 2) {
+         uint32_t rx = (x & s) > 0;
+         uint32_t ry = (y & s) > 0;
+         d += uint64_t(s) * s * ((3 * rx) ^ ry);
+         if (ry == 0) {
+            if (rx == 1) {
+               x = n - 1 - x;
+               y = n - 1 - y;
+            }
+            std::swap(x, y);
+         }
+      }
+      return d;
+   }
+
+   // Randomized incremental Delaunay triangulation (Bowyer-Watson) of a point set.
+   // Points are inserted in BRIO order: a random permutation split into rounds of doubling size,
+   // each round sorted along a Hilbert curve, so the point location walk from the last created
+   // triangle is short. The hull is closed by ghost triangles through a vertex at infinity,
+   // all decisions are made by the exact orientation and in_circle predicates.
+   // Ordering work runs on `threads` threads (0 means one per core) for large inputs,
+   // the insertion itself is sequential.
+   struct delaunay_builder {
+      size_t threads;
+      uint32_t seed;
+
+      delaunay_builder() : threads(0), seed(0) {}
+
+      // mesh.vertices is a copy of pts, duplicate points are left unreferenced
+      void build(const std::vector<point_2> &pts, triangle_mesh &mesh, bool with_neighbours = false) {
+         mesh.clear();
+         mesh.vertices.assign(pts.begin(), pts.end());
+         this->pts = &mesh.vertices;
+         inf = uint32_t(pts.size());
+
+         order_points();
+         tri.clear();
+         nbr.clear();
+         free_tris.clear();
+
+         if (start_triangle()) {
+            link.resize(pts.size() + 1);
+            for (size_t i = 3; i < order.size(); i++) insert(order[i]);
+         }
+         export_mesh(mesh, with_neighbours);
+         this->pts = nullptr;
+      }
+
+   private:
+      const std::vector<point_2> *pts;
+      uint32_t inf;
+      uint32_t hint;
+
+      std::vector<uint32_t> order;
+      std::vector<uint64_t> keys;
+      std::vector<uint32_t> tri, nbr, free_tris;
+      std::vector<uint32_t> stack, cavity, link, mark;
+      std::vector<uint32_t> boundary;
+      uint32_t stamp;
+
+      const point_2 &pt(uint32_t v) const {
+         return (*pts)[v];
+      }
+
+      bool is_ghost(uint32_t t) const {
+         return tri[3 * t] == inf || tri[3 * t + 1] == inf || tri[3 * t + 2] == inf;
+      }
+
+      void order_points() {
+         size_t n = pts->size();
+         order.resize(n);
+         for (uint32_t i = 0; i < n; i++) order[i] = i;
+         if (n == 0) return;
+
+         // drop duplicates
+         const std::vector<point_2> &p = *pts;
+         common::parallel_sort(order.begin(), order.end(), [&p](uint32_t a, uint32_t b) {
+            return p[a] < p[b] || (p[a] == p[b] && a < b);
+         }, threads);
+         order.erase(std::unique(order.begin(), order.end(), [&p](uint32_t a, uint32_t b) { return p[a] == p[b]; }),
+               order.end());
+         n = order.size();
+         if (n < 3) return;
+
+         double minx = p[order.front()].x, maxx = p[order.back()].x;
+         double miny = p[order[0]].y, maxy = miny;
+         for (uint32_t v : order) {
+            miny = std::min(miny, p[v].y);
+            maxy = std::max(maxy, p[v].y);
+         }
+         double scale = 65535. / std::max(std::max(maxx - minx, maxy - miny), 1e-300);
+
+         std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+
+         keys.resize(pts->size());
+         common::parallel_for(n, 1 << 14, [&](size_t first, size_t last) {
+            for (size_t i = first; i != last; ++i) {
+               const point_2 &q = p[order[i]];
+               keys[order[i]] = hilbert_index(uint32_t((q.x - minx) * scale), uint32_t((q.y - miny) * scale));
+            }
+         }, threads);
+
+         const std::vector<uint64_t> &k = keys;
+         auto by_key = [&k](uint32_t a, uint32_t b) { return k[a] < k[b]; };
+         for (size_t hi = n; hi > 0; hi /= 2) {
+            size_t lo = hi / 2 < 64 ? 0 : hi / 2;
+            common::parallel_sort(order.begin() + lo, order.begin() + hi, by_key, threads);
+            if (lo == 0) break;
+         }
+      }
+
+      // puts three non-collinear points first and creates the first triangle with its ghosts
+      bool start_triangle() {
+         if (order.size() < 3) return false;
+         size_t c = 2;
+         while (c < order.size() && orientation(pt(order[0]), pt(order[1]), pt(order[c])) == CG_COLLINEAR) c++;
+         if (c == order.size()) return false;
+         std::rotate(order.begin() + 2, order.begin() + c, order.begin() + c + 1);
+
+         uint32_t a = order[0], b = order[1], d = order[2];
+         if (orientation(pt(a), pt(b), pt(d)) == CG_RIGHT) std::swap(a, b);
+
+         // ghost gk lies across the side of t opposite to its k-th vertex
+         uint32_t t = new_triangle(a, b, d);
+         uint32_t g0 = new_triangle(d, b, inf);
+         uint32_t g1 = new_triangle(a, d, inf);
+         uint32_t g2 = new_triangle(b, a, inf);
+         set_nbr(t, g0, g1, g2);
+         set_nbr(g0, g2, g1, t);
+         set_nbr(g1, g0, g2, t);
+         set_nbr(g2, g1, g0, t);
+         hint = t;
+         mark.assign(tri.size() / 3, 0);
+         stamp = 0;
+         return true;
+      }
+
+      uint32_t new_triangle(uint32_t a, uint32_t b, uint32_t c) {
+         uint32_t t;
+         if (!free_tris.empty()) {
+            t = free_tris.back();
+            free_tris.pop_back();
+         } else {
+            t = tri.size() / 3;
+            tri.resize(tri.size() + 3);
+            nbr.resize(nbr.size() + 3);
+         }
+         tri[3 * t] = a;
+         tri[3 * t + 1] = b;
+         tri[3 * t + 2] = c;
+         return t;
+      }
+
+      void set_nbr(uint32_t t, uint32_t n0, uint32_t n1, uint32_t n2) {
+         nbr[3 * t] = n0;
+         nbr[3 * t + 1] = n1;
+         nbr[3 * t + 2] = n2;
+      }
+
+      bool in_conflict(uint32_t t, const point_2 &p) const {
+         const uint32_t *v = &tri[3 * t];
+         for (int k = 0; k < 3; k++) {
+            if (v[k] != inf) continue;
+            // ghost: hull edge u -> w with the outer side on its left
+            const point_2 &u = pt(v[(k + 1) % 3]), &w = pt(v[(k + 2) % 3]);
+            orientation_t o = orientation(u, w, p);
+            return o == CG_LEFT || (o == CG_COLLINEAR && collinear_are_ordered_along_line(u, p, w));
+         }
+         return in_circle(pt(v[0]), pt(v[1]), pt(v[2]), p) == CG_INSIDE;
+      }
+
+      // visibility walk from the hint, ends in a triangle containing p or in a ghost seeing p
+      uint32_t locate(const point_2 &p) {
+         uint32_t t = hint;
+         for (int k = 0; k < 3; k++) {
+            if (tri[3 * t + k] == inf) {
+               t = nbr[3 * t + k];
+               break;
+            }
+         }
+         uint32_t r = 0;
+         while (true) {
+            r = r * 1103515245u + 12345u;
+            int s = (r >> 16) % 3;
+            bool moved = false;
+            for (int i = 0; i < 3; i++) {
+               int k = (s + i) % 3;
+               const point_2 &u = pt(tri[3 * t + (k + 1) % 3]), &w = pt(tri[3 * t + (k + 2) % 3]);
+               if (orientation(u, w, p) == CG_RIGHT) {
+                  t = nbr[3 * t + k];
+                  moved = true;
+                  break;
+               }
+            }
+            if (!moved || is_ghost(t)) return t;
+         }
+      }
+
+      void insert(uint32_t v) {
+         const point_2 &p = pt(v);
+         uint32_t t0 = locate(p);
+
+         // collect the conflict region, boundary sides are kept as (u, w, outer triangle, its side index)
+         if (++stamp == 0) {
+            std::fill(mark.begin(), mark.end(), 0);
+            stamp = 1;
+         }
+         mark.resize(tri.size() / 3, 0);
+         cavity.clear();
+         boundary.clear();
+         stack.clear();
+         stack.push_back(t0);
+         mark[t0] = stamp;
+         while (!stack.empty()) {
+            uint32_t t = stack.back();
+            stack.pop_back();
+            cavity.push_back(t);
+            for (int k = 0; k < 3; k++) {
+               uint32_t n = nbr[3 * t + k];
+               if (mark[n] == stamp) continue;
+               if (in_conflict(n, p)) {
+                  mark[n] = stamp;
+                  stack.push_back(n);
+               } else {
+                  boundary.push_back(tri[3 * t + (k + 1) % 3]);
+                  boundary.push_back(tri[3 * t + (k + 2) % 3]);
+                  boundary.push_back(n);
+                  boundary.push_back(std::find(&nbr[3 * n], &nbr[3 * n] + 3, t) - &nbr[3 * n]);
+               }
+            }
+         }
+
+         for (uint32_t t : cavity) free_tris.push_back(t);
+
+         // star the cavity from v
+         for (size_t i = 0; i < boundary.size(); i += 4) {
+            uint32_t u = boundary[i], w = boundary[i + 1], out = boundary[i + 2];
+            uint32_t t = new_triangle(u, w, v);
+            nbr[3 * t + 2] = out;
+            nbr[3 * out + boundary[i + 3]] = t;
+            link[u] = t;
+         }
+         for (size_t i = 0; i < boundary.size(); i += 4) {
+            uint32_t t = link[boundary[i]];
+            uint32_t s = link[boundary[i + 1]];
+            nbr[3 * t] = s;
+            nbr[3 * s + 1] = t;
+            if (!is_ghost(t)) hint = t;
+         }
+      }
+
+      void export_mesh(triangle_mesh &mesh, bool with_neighbours) {
+         size_t count = tri.size() / 3;
+         // number the live finite triangles, the work buffers are not needed any more
+         std::vector<uint32_t> &dead = stack, &id = cavity;
+         dead.assign(count, 0);
+         for (uint32_t t : free_tris) dead[t] = 1;
+         id.assign(count, no_neighbour);
+         uint32_t live = 0;
+         for (uint32_t t = 0; t < count; t++) {
+            if (!dead[t] && !is_ghost(t)) id[t] = live++;
+         }
+         mesh.triangles.resize(3 * live);
+         if (with_neighbours) mesh.neighbours.resize(3 * live);
+         for (uint32_t t = 0; t < count; t++) {
+            if (id[t] == no_neighbour) continue;
+            for (int k = 0; k < 3; k++) {
+               mesh.triangles[3 * id[t] + k] = tri[3 * t + k];
+               if (with_neighbours) mesh.neighbours[3 * id[t] + k] = id[nbr[3 * t + k]];
+            }
+         }
+      }
+   };
+
+   inline void delaunay(const std::vector<point_2> &pts, triangle_mesh &mesh, bool with_neighbours = false) {
+      delaunay_builder().build(pts, mesh, with_neighbours);
+   }
+
+   inline triangle_mesh delaunay(const std::vector<point_2> &pts, bool with_neighbours = false) {
+      triangle_mesh mesh;
+      delaunay(pts, mesh, with_neighbours);
+      return mesh;
+   }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cg/primitives/point.h>
+#include <cg/primitives/triangle.h>
+
+namespace cg {
+   const uint32_t no_neighbour = uint32_t(-1);
+
+   // Indexed triangulation.
+   // Triangle i is (triangles[3i], triangles[3i + 1], triangles[3i + 2]) in vertices,
+   // neighbours[3i + k] is the triangle across the side opposite to its k-th vertex (or no_neighbour).
+   // neighbours is empty when they were not requested.
+   struct triangle_mesh {
+      std::vector<point_2> vertices;
+      std::vector<uint32_t> triangles;
+      std::vector<uint32_t> neighbours;
+
+      size_t size() const {
+         return triangles.size() / 3;
+      }
+
+      triangle_2 triangle(size_t i) const {
+         return triangle_2(vertices[triangles[3 * i]], vertices[triangles[3 * i + 1]], vertices[triangles[3 * i + 2]]);
+      }
+
+      // keeps the capacity, so a mesh can be reused as an output buffer
+      void clear() {
+         vertices.clear();
+         triangles.clear();
+         neighbours.clear();
+      }
+   };
+
+   // Fills mesh.neighbours by matching sides with equal vertex indices.
+   // scratch is only a work buffer, pass the same one to avoid allocations on repeated calls.
+   inline void build_neighbours(triangle_mesh &mesh, std::vector<uint32_t> &scratch) {
+      size_t n = mesh.vertices.size(), sides = mesh.triangles.size();
+      const std::vector<uint32_t> &t = mesh.triangles;
+      mesh.neighbours.assign(sides, no_neighbour);
+      scratch.assign(n + 1 + sides, 0);
+      uint32_t *start = scratch.data(), *bucket = start + n + 1;
+
+      // side h = 3i + k of triangle i joins its vertices k + 1 and k + 2
+      auto side_end = [&t](uint32_t h, uint32_t d) { return t[h - h % 3 + (h % 3 + d) % 3]; };
+      auto low = [&side_end](uint32_t h) { return std::min(side_end(h, 1), side_end(h, 2)); };
+      auto high = [&side_end](uint32_t h) { return std::max(side_end(h, 1), side_end(h, 2)); };
+
+      // bucket sides by their lower vertex
+      for (uint32_t h = 0; h < sides; h++) start[low(h) + 1]++;
+      for (size_t v = 0; v < n; v++) start[v + 1] += start[v];
+      for (uint32_t h = 0; h < sides; h++) bucket[start[low(h)]++] = h;
+      for (size_t v = n; v > 0; v--) start[v] = start[v - 1];
+      start[0] = 0;
+
+      for (size_t v = 0; v < n; v++) {
+         uint32_t *b = bucket + start[v], *e = bucket + start[v + 1];
+         std::sort(b, e, [&high](uint32_t h1, uint32_t h2) { return high(h1) < high(h2); });
+         for (uint32_t *h = b; h + 1 < e; h++) {
+            if (high(h[0]) != high(h[1])) continue;
+            mesh.neighbours[h[0]] = h[1] / 3;
+            mesh.neighbours[h[1]] = h[0] / 3;
+            h++;
+         }
+      }
+   }
+}
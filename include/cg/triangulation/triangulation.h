@@ -2,172 +2,491 @@
 
 #include <algorithm>
 #include <vector>
-#include <map>
-#include <memory>
+#include <cstdint>
 #include <cg/primitives/point.h>
 #include <cg/primitives/contour.h>
 #include <cg/primitives/triangle.h>
 #include <cg/primitives/segment.h>
 #include <cg/operations/orientation.h>
+#include <cg/operations/convex.h>
+#include <cg/triangulation/triangle_mesh.h>
 
 namespace cg {
    enum v_type {SPLIT, MERGE, LEFT_REGULAR, RIGHT_REGULAR, START, END};
 
-   v_type vertex_type(const contour_2::circulator_t &c) {
-      auto cur = *c;
-      auto prev = *(c - 1);
-      auto next = *(c + 1);
-
+   inline v_type vertex_type(const point_2 &prev, const point_2 &cur, const point_2 &next) {
       bool right = orientation(prev, cur, next) == CG_RIGHT;
       if (cur > prev && cur > next) return right ? SPLIT : START;
       if (cur < prev && cur < next) return right ? MERGE : END;
       return next > cur ? RIGHT_REGULAR : LEFT_REGULAR;
    }
 
+   inline v_type vertex_type(const contour_2::circulator_t &c) {
+      return vertex_type(*(c - 1), *c, *(c + 1));
+   }
+
+   // contours up to this size without holes are cut into ears instead of being swept
+   const size_t ear_clipping_max_vertices = 32;
+
+   // Fan of a convex counterclockwise contour. The apex is a strictly convex vertex whose neighbours are
+   // not straight, so no triangle is degenerate; returns false if there is no such vertex.
+   inline bool triangulate_convex(const contour_2 &c, std::vector<uint32_t> &triangles) {
+      uint32_t n = c.size();
+      if (n < 3) return false;
+      auto turn = [&c, n](uint32_t i) { return orientation(c[(i + n - 1) % n], c[i], c[(i + 1) % n]); };
+      for (uint32_t a = 0; a < n; a++) {
+         if (turn(a) != CG_LEFT || turn((a + 1) % n) != CG_LEFT || turn((a + n - 1) % n) != CG_LEFT) continue;
+         triangles.clear();
+         for (uint32_t i = 1; i + 1 < n; i++) {
+            triangles.push_back(a);
+            triangles.push_back((a + i) % n);
+            triangles.push_back((a + i + 1) % n);
+         }
+         return true;
+      }
+      return false;
+   }
+
+   // Ear clipping of a simple counterclockwise contour of at most ear_clipping_max_vertices vertices.
+   // Works on stack arrays, only the output is written to memory. Returns false if it runs out of ears,
+   // which only happens on degenerate input.
+   inline bool triangulate_ears(const contour_2 &c, std::vector<uint32_t> &triangles) {
+      uint32_t n = c.size();
+      if (n < 3 || n > ear_clipping_max_vertices) return false;
+      uint8_t prev[ear_clipping_max_vertices], next[ear_clipping_max_vertices];
+      uint8_t reflex[ear_clipping_max_vertices], reflex_num = 0;
+      bool convex[ear_clipping_max_vertices];
+      for (uint32_t i = 0; i < n; i++) {
+         prev[i] = (i + n - 1) % n;
+         next[i] = (i + 1) % n;
+      }
+      for (uint32_t i = 0; i < n; i++) {
+         convex[i] = orientation(c[prev[i]], c[i], c[next[i]]) == CG_LEFT;
+         if (!convex[i]) reflex[reflex_num++] = i;
+      }
+      // cutting an ear only makes the angles at its neighbours smaller, so the reflex list only shrinks
+      auto update = [&](uint32_t i) {
+         if (convex[i]) return;
+         convex[i] = orientation(c[prev[i]], c[i], c[next[i]]) == CG_LEFT;
+         if (!convex[i]) return;
+         uint8_t *r = std::find(reflex, reflex + reflex_num, i);
+         *r = reflex[--reflex_num];
+      };
+
+      // only a reflex (or straight) vertex can lie in the triangle of a convex vertex
+      auto is_ear = [&](uint32_t i) {
+         if (!convex[i]) return false;
+         const point_2 &a = c[prev[i]], &b = c[i], &d = c[next[i]];
+         double xmin = std::min(std::min(a.x, b.x), d.x), xmax = std::max(std::max(a.x, b.x), d.x);
+         double ymin = std::min(std::min(a.y, b.y), d.y), ymax = std::max(std::max(a.y, b.y), d.y);
+         for (uint8_t k = 0; k < reflex_num; k++) {
+            uint32_t j = reflex[k];
+            const point_2 &p = c[j];
+            if (j == prev[i] || j == next[i] || p.x < xmin || p.x > xmax || p.y < ymin || p.y > ymax) continue;
+            if (orientation(a, b, p) != CG_RIGHT && orientation(b, d, p) != CG_RIGHT
+                  && orientation(d, a, p) != CG_RIGHT) return false;
+         }
+         return true;
+      };
+
+      triangles.clear();
+      uint32_t i = 0, left = n, tried = 0;
+      while (left > 3) {
+         if (!is_ear(i)) {
+            if (++tried == left) return false;
+            i = next[i];
+            continue;
+         }
+         triangles.push_back(prev[i]);
+         triangles.push_back(i);
+         triangles.push_back(next[i]);
+         uint32_t p = prev[i], q = next[i];
+         next[p] = q;
+         prev[q] = p;
+         update(p);
+         update(q);
+         left--;
+         tried = 0;
+         i = p;
+      }
+      if (!convex[i]) return false;
+      triangles.push_back(prev[i]);
+      triangles.push_back(i);
+      triangles.push_back(next[i]);
+      return true;
+   }
+
+   // reflex chain of a monotone piece, stored as indices into the sweep vertex array
    struct monotone_chain {
       bool left;
-      std::vector<point_2> v;
-      monotone_chain() {}
+      std::vector<uint32_t> v;
+   };
+
+   // chains hanging on one status edge (there are never more than two)
+   struct chain_set {
+      uint32_t id[2];
+      uint32_t size;
 
-      monotone_chain(const segment_2 &s1, bool left) : left(left) {
-         v.push_back(s1[0]);
-         v.push_back(s1[1]);
+      chain_set() : size(0) {}
+
+      explicit chain_set(uint32_t size) : size(size) {
+         id[0] = id[1] = uint32_t(-1);
       }
    };
 
-   void add(std::vector<triangle_2> &result, std::vector<std::shared_ptr<monotone_chain>> &chains,
-         const segment_2 &s1, bool left = false) {
-      if (chains.size() == 0) {
-         chains.push_back(std::shared_ptr<monotone_chain>(new monotone_chain(s1, left)));
-         return;
-      }
-      for (auto &chain : chains) {
-         auto &v = chain->v;
-         auto &p1 = s1[1];
-         if (v.size() == 2 && s1[0] == v[0] && s1[1] == v[1]) continue;
-         if (s1[0] == v[0]) {
-            //other side
-            for (size_t i = 0; i < v.size() - 1; i++) {
-               result.push_back(triangle_2(p1, v[i + 1], v[i]));
-            }
-            v.erase(v.begin(), v.end() - 1);
-            v.push_back(p1);
-            chain->left ^= 1;
-         } else if (s1[0] == v.back()) {
-            //same side
-            orientation_t need = chain->left ? CG_RIGHT : CG_LEFT;
-            while (v.size() > 1 && orientation(p1, v[v.size() - 1], v[v.size() - 2]) == need) {
-               result.push_back(triangle_2(p1, v[v.size() - 1], v[v.size() - 2]));
-               v.pop_back();
+   // Sweep-line triangulation of a polygon with holes.
+   // Vertices of all contours are concatenated in input order, triangles are written as index triples
+   // into this array. Chains are taken from a pool and the sweep status is an array of sorted blocks,
+   // so a reused object does not allocate once it has seen a polygon of the same size.
+   struct triangulation_sweep {
+      struct sweep_edge {
+         uint32_t from, to;
+      };
+
+      struct status_entry {
+         sweep_edge e;
+         uint32_t helper;
+         chain_set chains;
+      };
+
+      std::vector<point_2> pts;
+      std::vector<uint32_t> prev, next, order;
+
+      // convex contours get a fan and small ones ear clipping, everything else (and whatever those
+      // give up on) goes through the sweep
+      void run(const std::vector<contour_2> &polygon, std::vector<uint32_t> &triangles) {
+         load(polygon);
+         if (!fast_path(polygon, triangles)) sweep(triangles);
+      }
+
+      void run(const std::vector<contour_2> &polygon, triangle_mesh &mesh, bool with_neighbours) {
+         load(polygon);
+         mesh.vertices.assign(pts.begin(), pts.end());
+         if (!fast_path(polygon, mesh.triangles)) sweep(mesh.triangles);
+         if (with_neighbours) {
+            build_neighbours(mesh, scratch);
+         } else {
+            mesh.neighbours.clear();
+         }
+      }
+
+      void load(const std::vector<contour_2> &polygon) {
+         pts.clear();
+         prev.clear();
+         next.clear();
+         for (const contour_2 &c : polygon) {
+            uint32_t base = pts.size(), n = c.size();
+            for (uint32_t i = 0; i < n; i++) {
+               pts.push_back(c[i]);
+               prev.push_back(base + (i + n - 1) % n);
+               next.push_back(base + (i + 1) % n);
             }
-            v.push_back(p1);
          }
+         contours_num = polygon.size();
       }
-   }
 
-   std::vector<triangle_2> triangulate(const std::vector<contour_2> &polygon) {
-      std::vector<triangle_2> result;
+      // number of triangles in a triangulation of the loaded polygon
+      size_t triangles_num() const {
+         size_t n = pts.size() + 2 * contours_num;
+         return n > 4 ? n - 4 : 0;
+      }
 
-      std::vector<contour_2::circulator_t> p;
-      for (const contour_2 &c : polygon) {
-         auto start = c.circulator();
-         auto cur = start;
-         do {
-            p.push_back(cur++);
-         } while (cur != start);
-      }
-      std::sort(p.begin(), p.end(),
-      [](const contour_2::circulator_t &c1, const contour_2::circulator_t &c2) { return *c1 > *c2; });
-      auto segment_comp = [](const segment_2 &s1, const segment_2 &s2) {
-               if (s1[0].x < s2[0].x) {
-                  auto res = orientation(s2[0], s2[1], s1[0]);
-                  if (res != CG_COLLINEAR) return res == CG_LEFT;
-               } else if (s2[0].x < s1[0].x) {
-                  auto res = orientation(s1[0], s1[1], s2[0]);
-                  if (res != CG_COLLINEAR) return res == CG_RIGHT;
-               }
-               if (s1[0] != s2[0]) return s1[0] < s2[0];
-               return s1[1] < s2[1];
-            };
-      typedef std::vector<std::shared_ptr<monotone_chain>> chains_t;
-      std::map<segment_2, std::pair<point_2, std::vector<std::shared_ptr<monotone_chain>>>,
-         decltype(segment_comp)> helper(segment_comp);
-      auto left_cont = [&helper, &result](const segment_2 &prev_edge, const point_2 &p, chains_t &res) {
-               const auto &ej = helper.lower_bound(prev_edge);
-               auto &old_helper = ej->second.first;
-               auto &chains = ej->second.second;
-               segment_2 new_seg(old_helper, p);
-               add(result, chains, prev_edge, true);
-               if (chains.size() == 2) {
-                  add(result, chains, new_seg);
-                  res[res.size() - 1] = chains[1];
-               } else {
-                  res[res.size() - 1] = chains[0];
-               }
-               helper[ej->first] = std::make_pair(p, res);
-               helper.erase(prev_edge);
-            };
-      auto right_cont = [&helper, &result](const segment_2 &rev_cur_edge, const point_2 &p, chains_t &res) {
-               segment_2 cur_vertex(p, p);
-               const auto &ej = helper.lower_bound(cur_vertex);
-               auto &old_helper = ej->second.first;
-               auto &chains = ej->second.second;
-               segment_2 new_seg(old_helper, p);
-               add(result, chains, rev_cur_edge, false);
-               res[0] = chains[0];
-               if (chains.size() == 2) add(result, chains, new_seg);
-               helper[ej->first] = std::make_pair(p, res);
-               helper.erase(cur_vertex);
-            };
-      for (auto &c : p) {
-         v_type type = vertex_type(c);
-         segment_2 prev_edge(*(c - 1), *c);
-         segment_2 cur_edge(*c, *(c + 1));
-         segment_2 rev_cur_edge(*(c + 1), *c);
-         segment_2 cur_vertex(*c, *c);
-         if (type == SPLIT) {
-            const auto &ej = helper.lower_bound(cur_vertex);
-            auto &old_helper = ej->second.first;
-            auto &chains = ej->second.second;
-            segment_2 new_seg(old_helper, *c);
-            chains_t new_chains;
-            point_2 new_helper;
-            new_helper = old_helper = *c;
-            add(result, chains, new_seg, false);
-            if (chains.size() == 2) {
-               //merge
-               new_chains.push_back(*(--chains.end()));
-               chains.erase(--chains.end());
-               helper[ej->first] = std::make_pair(old_helper, chains);
-               helper[cur_edge] = std::make_pair(new_helper, new_chains);
-            } else {
-               //ordinary
-               add(result, new_chains, new_seg, !chains[0]->left);
-               if (chains[0]->left) {
-                  helper[cur_edge] = std::make_pair(old_helper, chains);
-                  helper[ej->first] = std::make_pair(new_helper, new_chains);
+      bool fast_path(const std::vector<contour_2> &polygon, std::vector<uint32_t> &triangles) const {
+         if (polygon.size() != 1) return false;
+         const contour_2 &c = polygon[0];
+         if (convex(c) && triangulate_convex(c, triangles)) return true;
+         return c.size() <= ear_clipping_max_vertices && triangulate_ears(c, triangles);
+      }
+
+      void sweep(std::vector<uint32_t> &triangles) {
+         out = &triangles;
+         out->clear();
+         out->reserve(3 * triangles_num());
+         clear_status();
+         chains_used = 0;
+
+         order.resize(pts.size());
+         for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+         std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return pts[a] > pts[b] || (pts[a] == pts[b] && a < b);
+         });
+
+         for (uint32_t c : order) {
+            v_type type = vertex_type(pts[prev[c]], pts[c], pts[next[c]]);
+            sweep_edge prev_edge = {prev[c], c};
+            sweep_edge cur_edge = {c, next[c]};
+            sweep_edge rev_cur_edge = {next[c], c};
+            sweep_edge cur_vertex = {c, c};
+            if (type == SPLIT) {
+               status_entry &ej = at(lower_bound(cur_vertex));
+               sweep_edge ej_edge = ej.e;
+               uint32_t old_helper = ej.helper;
+               chain_set chains = ej.chains;
+               chain_set new_chains;
+               add(chains, old_helper, c, false);
+               if (chains.size == 2) {
+                  //merge
+                  new_chains.id[new_chains.size++] = chains.id[--chains.size];
+                  assign(cur_edge, c, new_chains, ej_edge, c, chains);
                } else {
-                  helper[cur_edge] = std::make_pair(new_helper, new_chains);
-                  helper[ej->first] = std::make_pair(old_helper, chains);
+                  //ordinary
+                  add(new_chains, old_helper, c, !pool[chains.id[0]].left);
+                  if (pool[chains.id[0]].left) {
+                     assign(cur_edge, c, chains, ej_edge, c, new_chains);
+                  } else {
+                     assign(cur_edge, c, new_chains, ej_edge, c, chains);
+                  }
                }
             }
+            chain_set res;
+            if (type == MERGE) res = chain_set(2);
+            else if (type == LEFT_REGULAR || type == RIGHT_REGULAR || type == END) res = chain_set(1);
+
+            if (type == MERGE) {
+               left_cont(prev_edge, c, res);
+               right_cont(rev_cur_edge, c, res);
+            }
+            if (type == END) {
+               right_cont(rev_cur_edge, c, res);
+               left_cont(prev_edge, c, res);
+            }
+            if (type == LEFT_REGULAR) left_cont(prev_edge, c, res);
+            if (type == RIGHT_REGULAR) right_cont(rev_cur_edge, c, res);
+
+            if (type == LEFT_REGULAR || type == START) {
+               status_entry &entry = find_or_insert(cur_edge);
+               entry.helper = c;
+               entry.chains = res;
+            }
+         }
+         out = nullptr;
+      }
+
+   private:
+      // status is a sorted sequence of small sorted blocks
+      enum { block_size = 128 };
+
+      struct position {
+         size_t block, offset;
+      };
+
+      std::vector<std::vector<status_entry>> status, spare_blocks;
+      std::vector<monotone_chain> pool;
+      std::vector<uint32_t> scratch;
+      size_t chains_used;
+      size_t contours_num;
+      std::vector<uint32_t> *out;
+
+      bool less(const sweep_edge &s1, const sweep_edge &s2) const {
+         const point_2 &a0 = pts[s1.from], &a1 = pts[s1.to];
+         const point_2 &b0 = pts[s2.from], &b1 = pts[s2.to];
+         // a degenerate edge {v, v} is a query for vertex v, it is collinear with anything;
+         // so is an endpoint of the other edge, which would otherwise go all the way to the exact predicate
+         if (a0.x < b0.x && s2.from != s2.to && a0 != b1) {
+            auto res = orientation(b0, b1, a0);
+            if (res != CG_COLLINEAR) return res == CG_LEFT;
+         } else if (b0.x < a0.x && s1.from != s1.to && b0 != a1) {
+            auto res = orientation(a0, a1, b0);
+            if (res != CG_COLLINEAR) return res == CG_RIGHT;
+         }
+         if (a0 != b0) return a0 < b0;
+         return a1 < b1;
+      }
+
+      status_entry &at(const position &p) {
+         return status[p.block][p.offset];
+      }
+
+      bool found(const position &p, const sweep_edge &e) const {
+         return p.block != status.size() && !less(e, status[p.block][p.offset].e);
+      }
+
+      position lower_bound(const sweep_edge &e) const {
+         auto less_e = [this, &e](const status_entry &s) { return less(s.e, e); };
+         position p;
+         p.block = std::partition_point(status.begin(), status.end(),
+               [&less_e](const std::vector<status_entry> &b) { return less_e(b.back()); }) - status.begin();
+         p.offset = 0;
+         if (p.block != status.size()) {
+            const std::vector<status_entry> &b = status[p.block];
+            p.offset = std::partition_point(b.begin(), b.end(), less_e) - b.begin();
+         }
+         return p;
+      }
+
+      std::vector<status_entry> new_block() {
+         std::vector<status_entry> b;
+         if (!spare_blocks.empty()) {
+            b.swap(spare_blocks.back());
+            spare_blocks.pop_back();
+         }
+         return b;
+      }
+
+      void clear_status() {
+         for (auto &b : status) {
+            b.clear();
+            spare_blocks.push_back(std::vector<status_entry>());
+            spare_blocks.back().swap(b);
+         }
+         status.clear();
+      }
+
+      status_entry &find_or_insert(const sweep_edge &e) {
+         position p = lower_bound(e);
+         if (found(p, e)) return at(p);
+
+         if (status.empty()) {
+            status.push_back(new_block());
+         } else if (p.block == status.size()) {
+            p.block = status.size() - 1;
+            p.offset = status.back().size();
+         }
+         status_entry entry;
+         entry.e = e;
+         entry.helper = 0;
+         std::vector<status_entry> &b = status[p.block];
+         b.insert(b.begin() + p.offset, entry);
+
+         if (b.size() > 2 * block_size) {
+            status.insert(status.begin() + p.block + 1, new_block());
+            std::vector<status_entry> &lo = status[p.block], &hi = status[p.block + 1];
+            hi.assign(lo.begin() + block_size, lo.end());
+            lo.resize(block_size);
+            if (p.offset >= block_size) {
+               p.block++;
+               p.offset -= block_size;
+            }
          }
-         chains_t res;
-         if (type == MERGE) res = chains_t(2);
-         else if (type == LEFT_REGULAR || type == RIGHT_REGULAR || type == END) res = chains_t(1);
+         return at(p);
+      }
 
-         if (type == MERGE) {
-            left_cont(prev_edge, *c, res);
-            right_cont(rev_cur_edge, *c, res);
+      void erase(const sweep_edge &e) {
+         position p = lower_bound(e);
+         if (!found(p, e)) return;
+         std::vector<status_entry> &b = status[p.block];
+         b.erase(b.begin() + p.offset);
+         if (b.empty()) {
+            spare_blocks.push_back(std::vector<status_entry>());
+            spare_blocks.back().swap(b);
+            status.erase(status.begin() + p.block);
          }
-         if (type == END) {
-            right_cont(rev_cur_edge, *c, res);
-            left_cont(prev_edge, *c, res);
+      }
+
+      // stores new_edge and then overwrites the entry with key old_edge, in this order
+      void assign(const sweep_edge &new_edge, uint32_t new_helper, const chain_set &new_chains,
+            const sweep_edge &old_edge, uint32_t old_helper, const chain_set &old_chains) {
+         status_entry &n = find_or_insert(new_edge);
+         n.helper = new_helper;
+         n.chains = new_chains;
+         status_entry &o = at(lower_bound(old_edge));
+         o.helper = old_helper;
+         o.chains = old_chains;
+      }
+
+      uint32_t new_chain(uint32_t s0, uint32_t s1, bool left) {
+         if (chains_used == pool.size()) pool.push_back(monotone_chain());
+         monotone_chain &chain = pool[chains_used];
+         chain.left = left;
+         chain.v.clear();
+         chain.v.push_back(s0);
+         chain.v.push_back(s1);
+         return chains_used++;
+      }
+
+      void emit(uint32_t a, uint32_t b, uint32_t c) {
+         out->push_back(a);
+         out->push_back(b);
+         out->push_back(c);
+      }
+
+      void add(chain_set &chains, uint32_t s0, uint32_t s1, bool left) {
+         if (chains.size == 0) {
+            chains.id[chains.size++] = new_chain(s0, s1, left);
+            return;
+         }
+         const point_2 &p0 = pts[s0], &p1 = pts[s1];
+         for (uint32_t k = 0; k < chains.size; k++) {
+            monotone_chain &chain = pool[chains.id[k]];
+            auto &v = chain.v;
+            if (v.size() == 2 && p0 == pts[v[0]] && p1 == pts[v[1]]) continue;
+            if (p0 == pts[v[0]]) {
+               //other side
+               for (size_t i = 0; i < v.size() - 1; i++) {
+                  emit(s1, v[i + 1], v[i]);
+               }
+               v.erase(v.begin(), v.end() - 1);
+               v.push_back(s1);
+               chain.left ^= 1;
+            } else if (p0 == pts[v.back()]) {
+               //same side
+               orientation_t need = chain.left ? CG_RIGHT : CG_LEFT;
+               while (v.size() > 1 && orientation(p1, pts[v[v.size() - 1]], pts[v[v.size() - 2]]) == need) {
+                  emit(s1, v[v.size() - 1], v[v.size() - 2]);
+                  v.pop_back();
+               }
+               v.push_back(s1);
+            }
+         }
+      }
+
+      void left_cont(const sweep_edge &prev_edge, uint32_t p, chain_set &res) {
+         status_entry &ej = at(lower_bound(prev_edge));
+         uint32_t old_helper = ej.helper;
+         chain_set &chains = ej.chains;
+         add(chains, prev_edge.from, prev_edge.to, true);
+         if (chains.size == 2) {
+            add(chains, old_helper, p, false);
+            res.id[res.size - 1] = chains.id[1];
+         } else {
+            res.id[res.size - 1] = chains.id[0];
          }
-         if (type == LEFT_REGULAR) left_cont(prev_edge, *c, res);
-         if (type == RIGHT_REGULAR) right_cont(rev_cur_edge, *c, res);
+         ej.helper = p;
+         ej.chains = res;
+         erase(prev_edge);
+      }
+
+      void right_cont(const sweep_edge &rev_cur_edge, uint32_t p, chain_set &res) {
+         sweep_edge cur_vertex = {p, p};
+         status_entry &ej = at(lower_bound(cur_vertex));
+         uint32_t old_helper = ej.helper;
+         chain_set &chains = ej.chains;
+         add(chains, rev_cur_edge.from, rev_cur_edge.to, false);
+         res.id[0] = chains.id[0];
+         if (chains.size == 2) add(chains, old_helper, p, false);
+         ej.helper = p;
+         ej.chains = res;
+         erase(cur_vertex);
+      }
+   };
+
+   // triangles as index triples into the concatenation of the polygon contours
+   inline void triangulate(const std::vector<contour_2> &polygon, std::vector<uint32_t> &triangles) {
+      triangulation_sweep().run(polygon, triangles);
+   }
 
-         if (type == LEFT_REGULAR || type == START) helper[cur_edge] = std::make_pair(*c, res);
+   // indexed mesh over the concatenation of the polygon contours;
+   // reusing mesh and sweep makes repeated triangulations allocation free
+   inline void triangulate(const std::vector<contour_2> &polygon, triangle_mesh &mesh, triangulation_sweep &sweep,
+         bool with_neighbours = false) {
+      sweep.run(polygon, mesh, with_neighbours);
+   }
+
+   inline triangle_mesh triangulate_mesh(const std::vector<contour_2> &polygon, bool with_neighbours = false) {
+      triangle_mesh mesh;
+      triangulation_sweep().run(polygon, mesh, with_neighbours);
+      return mesh;
+   }
+
+   inline std::vector<triangle_2> triangulate(const std::vector<contour_2> &polygon) {
+      triangulation_sweep sweep;
+      std::vector<uint32_t> idx;
+      sweep.run(polygon, idx);
+
+      std::vector<triangle_2> result;
+      result.reserve(idx.size() / 3);
+      for (size_t i = 0; i < idx.size(); i += 3) {
+         result.push_back(triangle_2(sweep.pts[idx[i]], sweep.pts[idx[i + 1]], sweep.pts[idx[i + 2]]));
       }
       return result;
    }
@@ -0,0 +1,93 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include <cg/intersections/bentley_ottmann.h>
+
+using namespace std;
+using namespace cg;
+
+typedef pair<size_t, size_t> index_pair;
+
+// the sweep reports each intersecting pair once, as the pairwise has_intersection
+static void check(vector<segment_2> const & segments)
+{
+   vector<index_pair> pairs;
+   intersecting_pairs(segments, back_inserter(pairs));
+   size_t reported = pairs.size();
+   sort(pairs.begin(), pairs.end());
+   EXPECT_EQ(reported, size_t(unique(pairs.begin(), pairs.end()) - pairs.begin()));
+
+   vector<index_pair> expected;
+   for (size_t i = 0; i != segments.size(); ++i)
+      for (size_t j = i + 1; j != segments.size(); ++j)
+         if (has_intersection(segments[i], segments[j]))
+            expected.push_back(index_pair(i, j));
+   EXPECT_EQ(expected, pairs);
+}
+
+TEST(bentley_ottmann, random)
+{
+   mt19937 gen(1);
+   uniform_real_distribution<double> d(-100, 100), len(-20, 20);
+   for (int k = 0; k != 10; ++k)
+   {
+      vector<segment_2> segments;
+      for (int l = 0; l != 300; ++l)
+      {
+         point_2 a(d(gen), d(gen));
+         segments.push_back(segment_2(a, point_2(a.x + len(gen), a.y + len(gen))));
+      }
+      check(segments);
+   }
+}
+
+TEST(bentley_ottmann, integer_grid)
+{
+   // touching ends, collinear overlaps, vertical and zero length segments, several crossings at one point
+   mt19937 gen(2);
+   uniform_int_distribution<int> d(0, 8);
+   for (int k = 0; k != 50; ++k)
+   {
+      vector<segment_2> segments;
+      for (int l = 0; l != 60; ++l)
+         segments.push_back(segment_2(point_2(d(gen), d(gen)), point_2(d(gen), d(gen))));
+      check(segments);
+   }
+}
+
+TEST(bentley_ottmann, pencil)
+{
+   // segments through one point, and crossings of rational coordinates next to each other
+   vector<segment_2> segments;
+   for (int l = 0; l != 20; ++l)
+      segments.push_back(segment_2(point_2(-l - 1, -3 * l + 1), point_2(l + 1, 3 * l - 1)));
+   for (int l = 0; l != 20; ++l)
+      segments.push_back(segment_2(point_2(0.1 * l, -100), point_2(0.1 * l + 1e-9, 100)));
+   segments.push_back(segment_2(point_2(0, -50), point_2(0, 50)));
+   check(segments);
+}
+
+TEST(bentley_ottmann, points)
+{
+   mt19937 gen(3);
+   uniform_real_distribution<double> d(-1, 1);
+   vector<segment_2> segments;
+   for (int l = 0; l != 100; ++l)
+   {
+      point_2 a(d(gen), d(gen)), b(d(gen), d(gen));
+      segments.push_back(segment_2(a, b));
+      segments.push_back(segment_2(a, a));
+      segments.push_back(segment_2(point_2((a.x + b.x) / 2, (a.y + b.y) / 2), point_2((a.x + b.x) / 2, (a.y + b.y) / 2)));
+   }
+   check(segments);
+
+   vector<point_2> seen;
+   for_each_intersection(vector<segment_2>(1, segment_2(point_2(0, 0), point_2(2, 2))), [&](size_t, size_t, point_2 const & p) { seen.push_back(p); });
+   EXPECT_TRUE(seen.empty());
+   vector<segment_2> cross = {segment_2(point_2(0, 0), point_2(2, 2)), segment_2(point_2(0, 2), point_2(2, 0))};
+   for_each_intersection(cross, [&](size_t i, size_t j, point_2 const & p) { seen.push_back(p); EXPECT_EQ(0u, i); EXPECT_EQ(1u, j); });
+   ASSERT_EQ(1u, seen.size());
+   EXPECT_EQ(point_2(1, 1), seen[0]);
+}
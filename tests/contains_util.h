@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include <cg/primitives/contour.h>
+
+// inputs shared by the tests of the structures prepared for contains
+
+namespace contains_util
+{
+   inline std::vector<cg::point_2> random_points(std::mt19937 & gen, size_t n, double range)
+   {
+      std::uniform_real_distribution<double> d(-range, range);
+      std::vector<cg::point_2> pts;
+      for (size_t l = 0; l != n; ++l)
+         pts.push_back(cg::point_2(d(gen), d(gen)));
+      return pts;
+   }
+
+   // star shaped polygon with a noisy radius, like a geofence
+   inline cg::contour_2 star(std::mt19937 & gen, size_t n, double noise)
+   {
+      std::uniform_real_distribution<double> r(1 - noise, 1 + noise);
+      std::vector<cg::point_2> pts;
+      for (size_t l = 0; l != n; ++l)
+      {
+         double t = 2 * M_PI * l / n, radius = 100 * r(gen);
+         pts.push_back(cg::point_2(radius * cos(t), radius * sin(t)));
+      }
+      return cg::contour_2(pts);
+   }
+}
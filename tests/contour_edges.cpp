@@ -0,0 +1,74 @@
+#include <vector>
+#include <random>
+#include <memory>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include <cg/operations/contains/contour_edges.h>
+
+#include "contains_util.h"
+
+using namespace std;
+using namespace cg;
+using namespace contains_util;
+
+// single and batch queries answer as contains, boundary included
+static void check(contour_2 const & c, vector<point_2> const & queries)
+{
+   contour_edges edges(c);
+   unique_ptr<bool[]> batch(new bool[queries.size()]);
+   edges.contains(queries.data(), queries.size(), batch.get());
+   for (size_t l = 0; l != queries.size(); ++l)
+   {
+      bool expected = contains(c, queries[l]);
+      EXPECT_EQ(expected, batch[l]) << queries[l].x << " " << queries[l].y;
+      EXPECT_EQ(expected, contains(edges, queries[l])) << queries[l].x << " " << queries[l].y;
+   }
+}
+
+TEST(contour_edges, star)
+{
+   mt19937 gen(1);
+   for (size_t n : {3, 10, 3000})
+   {
+      contour_2 c = star(gen, n, 0.5);
+      vector<point_2> queries = random_points(gen, 5000, 130);
+      queries.insert(queries.end(), c.begin(), c.end());
+      check(c, queries);
+   }
+}
+
+TEST(contour_edges, self_intersecting)
+{
+   mt19937 gen(2);
+   vector<point_2> pts = random_points(gen, 200, 50);
+   check(contour_2(pts), random_points(gen, 20000, 60));
+}
+
+TEST(contour_edges, integer_grid)
+{
+   // many queries on edges and vertices, decided by ray_crossing after the filter
+   mt19937 gen(3);
+   uniform_int_distribution<int> d(0, 12);
+   for (int k = 0; k != 20; ++k)
+   {
+      vector<point_2> pts;
+      for (int l = 0; l != 30; ++l)
+         pts.push_back(point_2(d(gen), d(gen)));
+
+      vector<point_2> queries;
+      for (double x = -1; x <= 13; x += 0.5)
+         for (double y = -1; y <= 13; y += 0.5)
+            queries.push_back(point_2(x, y));
+      check(contour_2(pts), queries);
+   }
+}
+
+TEST(contour_edges, degenerate)
+{
+   vector<point_2> queries = {point_2(0, 0), point_2(1, 1), point_2(2, 1)};
+   check(contour_2(), queries);
+   check(contour_2(vector<point_2>(1, point_2(1, 1))), queries);
+   vector<point_2> flat = {point_2(0, 1), point_2(2, 1), point_2(1, 1)};
+   check(contour_2(flat), queries);
+}
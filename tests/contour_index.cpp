@@ -0,0 +1,76 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include <cg/operations/contains/contour_index.h>
+
+#include "contains_util.h"
+
+using namespace std;
+using namespace cg;
+using namespace contains_util;
+
+// on the boundary by the index exactly when by contains
+static void check(contour_2 const & c, vector<point_2> const & queries)
+{
+   contour_index index(c);
+   for (point_2 const & q : queries)
+      EXPECT_EQ(index.contains(q), contains(c, q)) << q.x << " " << q.y;
+}
+
+TEST(contour_index, star)
+{
+   mt19937 gen(1);
+   for (size_t n : {3, 10, 1000})
+   {
+      contour_2 c = star(gen, n, 0.5);
+      vector<point_2> queries = random_points(gen, 20000, 130);
+      for (point_2 const & p : c)
+         queries.push_back(p);
+      check(c, queries);
+   }
+}
+
+TEST(contour_index, self_intersecting)
+{
+   mt19937 gen(2);
+   vector<point_2> pts = random_points(gen, 200, 50);
+   check(contour_2(pts), random_points(gen, 20000, 60));
+}
+
+TEST(contour_index, integer_grid)
+{
+   // integer vertices with many equal coordinates, queried at vertices, edge midpoints and grid points
+   mt19937 gen(3);
+   uniform_int_distribution<int> d(0, 12);
+   for (int k = 0; k != 20; ++k)
+   {
+      vector<point_2> pts;
+      for (int l = 0; l != 30; ++l)
+         pts.push_back(point_2(d(gen), d(gen)));
+      contour_2 c(pts);
+
+      vector<point_2> queries;
+      for (double x = -1; x <= 13; x += 0.5)
+         for (double y = -1; y <= 13; y += 0.5)
+            queries.push_back(point_2(x, y));
+      check(c, queries);
+   }
+}
+
+TEST(contour_index, degenerate)
+{
+   check(contour_2(), vector<point_2>(1, point_2(0, 0)));
+
+   vector<point_2> queries;
+   for (double x = -1; x <= 3; x += 0.5)
+      for (double y = -1; y <= 3; y += 0.5)
+         queries.push_back(point_2(x, y));
+
+   check(contour_2(vector<point_2>(1, point_2(1, 1))), queries);
+   vector<point_2> flat = {point_2(0, 1), point_2(2, 1), point_2(1, 1)};
+   check(contour_2(flat), queries);
+   vector<point_2> vertical = {point_2(1, 0), point_2(1, 2)};
+   check(contour_2(vertical), queries);
+}
@@ -0,0 +1,132 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <gtest/gtest.h>
+
+#include <cg/operations/convex_intersection.h>
+#include <cg/operations/convex.h>
+#include <cg/operations/contains/contour_point.h>
+#include <cg/intersections/polygon_boolean.h>
+#include <cg/convex_hull/graham.h>
+
+using namespace std;
+using namespace cg;
+
+static contour_2 hull(vector<point_2> pts)
+{
+   pts.erase(graham_hull(pts.begin(), pts.end()), pts.end());
+   return contour_2(pts);
+}
+
+static double area(contour_2 const & c)
+{
+   double res = 0;
+   for (size_t l = 0; l != c.size(); ++l)
+      res += c[l].x * c[(l + 1) % c.size()].y - c[l].y * c[(l + 1) % c.size()].x;
+   return res / 2;
+}
+
+// the result is convex of ccw orientation, fits in n + m points, has the area of the intersection
+// by the general sweep and holds the points of both
+static void check(contour_2 const & a, contour_2 const & b, mt19937 & gen)
+{
+   size_t room = a.size() + b.size();
+   vector<point_2> buffer(room + 4, point_2(numeric_limits<double>::quiet_NaN(), 0));
+   size_t k = convex_intersection(a, b, buffer.data()) - buffer.data();
+   ASSERT_LE(k, room);
+   for (size_t l = room; l != buffer.size(); ++l)
+      ASSERT_TRUE(std::isnan(buffer[l].x));
+
+   contour_2 res(vector<point_2>(buffer.begin(), buffer.begin() + k));
+   EXPECT_TRUE(k == 0 || k >= 3);
+   EXPECT_TRUE(counterclockwise(res));
+   EXPECT_TRUE(convex(res));
+
+   vector<contour_2> sweep = detail::sweep_boolean(vector<contour_2>(1, a), vector<contour_2>(1, b), CG_INTERSECTION);
+   double expected = 0;
+   for (contour_2 const & c : sweep)
+      expected += area(c);
+   EXPECT_NEAR(expected, area(res), 1e-9 * (1 + expected));
+
+   double x0 = a[0].x, x1 = a[0].x, y0 = a[0].y, y1 = a[0].y;
+   for (point_2 const & p : a)
+      x0 = min(x0, p.x), x1 = max(x1, p.x), y0 = min(y0, p.y), y1 = max(y1, p.y);
+   uniform_real_distribution<double> dx(x0 - 1, x1 + 1), dy(y0 - 1, y1 + 1);
+   for (int l = 0; l != 200; ++l)
+   {
+      point_2 q(dx(gen), dy(gen));
+      EXPECT_EQ(convex_contains(a, q) && convex_contains(b, q), k != 0 && convex_contains(res, q)) << q.x << " " << q.y;
+   }
+}
+
+TEST(convex_intersection, random)
+{
+   mt19937 gen(1);
+   uniform_real_distribution<double> d(-10, 10), shift(-8, 8);
+   for (int k = 0; k != 300; ++k)
+   {
+      contour_2 c[2];
+      for (int s = 0; s != 2; ++s)
+      {
+         vector<point_2> pts;
+         double x = shift(gen), y = shift(gen);
+         for (int l = 0; l != 3 + k % 20; ++l)
+            pts.push_back(point_2(x + d(gen), y + d(gen)));
+         c[s] = hull(pts);
+      }
+      check(c[0], c[1], gen);
+   }
+}
+
+TEST(convex_intersection, integer_grid)
+{
+   // vertices on sides of the other, common sides, equal and touching contours
+   mt19937 gen(2);
+   uniform_int_distribution<int> d(0, 6);
+   for (int k = 0; k != 2000; ++k)
+   {
+      contour_2 c[2];
+      for (int s = 0; s != 2; ++s)
+      {
+         vector<point_2> pts;
+         for (int l = 0; l != 3 + k % 6; ++l)
+            pts.push_back(point_2(d(gen), d(gen)));
+         c[s] = hull(pts);
+      }
+      if (c[0].size() >= 3 && c[1].size() >= 3)
+         check(c[0], c[1], gen);
+   }
+}
+
+TEST(convex_intersection, special)
+{
+   mt19937 gen(3);
+   contour_2 square(vector<point_2>{point_2(0, 0), point_2(2, 0), point_2(2, 2), point_2(0, 2)});
+   contour_2 diamond(vector<point_2>{point_2(1, -0.5), point_2(2.5, 1), point_2(1, 2.5), point_2(-0.5, 1)});
+   contour_2 inner(vector<point_2>{point_2(0, 0), point_2(1, 0), point_2(1, 1), point_2(0, 1)});
+   contour_2 corner(vector<point_2>{point_2(2, 2), point_2(3, 2), point_2(3, 3), point_2(2, 3)});
+   contour_2 side(vector<point_2>{point_2(2, 0), point_2(3, 0), point_2(3, 2), point_2(2, 2)});
+   contour_2 far(vector<point_2>{point_2(5, 5), point_2(6, 5), point_2(6, 6), point_2(5, 6)});
+   // the square with vertices in the middle of sides and a repeated vertex
+   contour_2 dense(vector<point_2>{point_2(0, 0), point_2(1, 0), point_2(2, 0), point_2(2, 0), point_2(2, 2), point_2(0, 2), point_2(0, 1)});
+
+   EXPECT_EQ(4u, convex_intersection(square, square).size());
+   EXPECT_DOUBLE_EQ(4, area(convex_intersection(square, square)));
+   EXPECT_DOUBLE_EQ(1, area(convex_intersection(square, inner)));
+   EXPECT_DOUBLE_EQ(1, area(convex_intersection(inner, square)));
+   EXPECT_EQ(4u, convex_intersection(square, dense).size());
+   EXPECT_EQ(4u, convex_intersection(dense, dense).size());
+   EXPECT_EQ(8u, convex_intersection(square, diamond).size());
+   EXPECT_DOUBLE_EQ(3.5, area(convex_intersection(square, diamond)));
+
+   for (contour_2 const & c : {corner, side, far})
+   {
+      EXPECT_EQ(0u, convex_intersection(square, c).size());
+      EXPECT_EQ(0u, convex_intersection(c, square).size());
+   }
+
+   for (contour_2 const & a : {square, diamond, inner, corner, side, far, dense})
+      for (contour_2 const & b : {square, diamond, inner, corner, side, far, dense})
+         check(a, b, gen);
+}
@@ -0,0 +1,553 @@
+#include <vector>
+#include <random>
+#include <type_traits>
+#include <gtest/gtest.h>
+
+#include "cg/dcel/kirkpatrick.h"
+#include "cg/dcel/trapezoidal_map.h"
+
+using namespace std;
+using namespace cg;
+
+line random_line(mt19937 & gen)
+{
+    uniform_real_distribution<double> d(-100, 100);
+    point_2 a(d(gen), d(gen)), b(d(gen), d(gen));
+    double A = b.y - a.y, B = a.x - b.x;
+    line l(A, B, -(A * a.x + B * a.y));
+    if (!is_direct_vector_right(l)) {
+        l.inverse_vector();
+    }
+    return l;
+}
+
+// twins, next / prev and faces agree, returns the number of face loops reachable from inf_node
+size_t check_dcel(const DCEL & dcel)
+{
+    vector<char> live(dcel.edges.size());
+    vector<uint32_t> stack(1, dcel.vertices[dcel.inf_node].e);
+    while (!stack.empty()) {
+        uint32_t e = stack.back();
+        stack.pop_back();
+        if (live[e]) continue;
+        live[e] = 1;
+        stack.push_back(dcel.twin(e));
+        stack.push_back(dcel.next(e));
+    }
+
+    size_t loops = 0;
+    vector<char> seen(dcel.edges.size());
+    for (uint32_t e = 0; e < dcel.edges.size(); e++) {
+        if (!live[e]) continue;
+        EXPECT_EQ(dcel.twin(dcel.twin(e)), e);
+        EXPECT_EQ(dcel.prev(dcel.next(e)), e);
+        EXPECT_EQ(dcel.origin(dcel.next(e)), dcel.origin(dcel.twin(e)));
+
+        if (seen[e]) continue;
+        loops++;
+        uint32_t f = e;
+        do {
+            seen[f] = 1;
+            EXPECT_EQ(dcel.edges[f].face, dcel.edges[e].face);
+            f = dcel.next(f);
+        } while (f != e);
+        EXPECT_LT(dcel.edges[e].face, dcel.faces.size());
+        EXPECT_EQ(dcel.edges[dcel.faces[dcel.edges[e].face].e].face, dcel.edges[e].face);
+    }
+    return loops;
+}
+
+TEST(dcel, arrangement)
+{
+    mt19937 gen(1);
+    DCEL dcel(random_line(gen), random_line(gen));
+    EXPECT_EQ(check_dcel(dcel), 4);
+
+    for (size_t n = 3; n <= 30; n++) {
+        dcel.add_line(random_line(gen));
+        // lines in general position: C(n, 2) vertices plus the infinite one, 1 + n + C(n, 2) faces
+        EXPECT_EQ(dcel.vertices.size(), n * (n - 1) / 2 + 1);
+        EXPECT_EQ(dcel.faces.size(), 1 + n + n * (n - 1) / 2);
+        EXPECT_EQ(check_dcel(dcel), dcel.faces.size());
+    }
+}
+
+TEST(dcel, copy)
+{
+    mt19937 gen(2);
+    DCEL dcel(random_line(gen), random_line(gen));
+    for (int i = 0; i < 10; i++) {
+        dcel.add_line(random_line(gen));
+    }
+
+    DCEL other(dcel);
+    other.add_line(random_line(gen));
+    EXPECT_EQ(dcel.all_lines.size(), 12);
+    EXPECT_EQ(other.all_lines.size(), 13);
+    EXPECT_EQ(check_dcel(dcel), dcel.faces.size());
+    EXPECT_EQ(check_dcel(other), other.faces.size());
+}
+
+TEST(dcel, localization)
+{
+    mt19937 gen(3);
+    uniform_real_distribution<double> d(-50, 50);
+    kirkpatrick_localization kl(random_line(gen), random_line(gen));
+    for (int i = 0; i < 12; i++) {
+        kl.add_line(random_line(gen));
+    }
+
+    vector<vector<uint32_t>> deleted_vertices;
+    kl.build_triangulation(deleted_vertices);
+    ASSERT_NE(kl.root, no_index);
+
+    const DCEL & triangles = kl.levels[0].dcel;
+    for (int i = 0; i < 200; i++) {
+        point_2 p(d(gen), d(gen));
+
+        uint32_t e = kl.naive_localization(p);
+        ASSERT_NE(e, no_index);
+        uint32_t f = e;
+        do {
+            EXPECT_NE(kl.dcel.point2edge_orientation(f, p), CG_RIGHT);
+            f = kl.dcel.next(f);
+        } while (f != e);
+
+        uint32_t t = kl.fast_localization(p);
+        ASSERT_NE(t, no_index);
+        EXPECT_TRUE(triangle_contains_point(triangles.triangle(triangles.origin(t),
+                                                               triangles.origin(triangles.next(t)),
+                                                               triangles.origin(triangles.next(triangles.next(t)))), p));
+
+        // locate works after a plain build_triangulation, not only after rebuild
+        EXPECT_EQ(kl.locate(p), kl.dcel.edges[e].face);
+    }
+}
+
+// descent over kirkpatrick_localization::nodes with the exact predicate only
+uint32_t dag_descent(const kirkpatrick_localization & kl, const point_2 & p)
+{
+    line l1(1, 0, -p.x), l2(0, 1, -p.y);
+    if (!triangle_contains_convex_point(kl.nodes[kl.root].t, l1, l2)) {
+        return no_index;
+    }
+    uint32_t v = kl.root;
+    while (!kl.nodes[v].is_leaf) {
+        uint32_t next = no_index;
+        for (uint32_t child : kl.nodes[v].children) {
+            if (triangle_contains_convex_point(kl.nodes[child].t, l1, l2)) {
+                next = child;
+                break;
+            }
+        }
+        if (next == no_index) {
+            return no_index;
+        }
+        v = next;
+    }
+    return kl.nodes[v].node_edge;
+}
+
+TEST(dcel, frozen_dag)
+{
+    mt19937 gen(7);
+    uniform_real_distribution<double> d(-100, 100), jitter(-1e-12, 1e-12);
+    kirkpatrick_localization kl(random_line(gen), random_line(gen));
+    for (int i = 0; i < 20; i++) {
+        kl.add_line(random_line(gen));
+    }
+
+    vector<vector<uint32_t>> deleted_vertices;
+    kl.build_triangulation(deleted_vertices);
+    ASSERT_NE(kl.root, no_index);
+
+    for (int i = 0; i < 1000; i++) {
+        point_2 p(d(gen), d(gen));
+        EXPECT_EQ(kl.fast_localization(p), dag_descent(kl, p));
+    }
+
+    // points on and next to the vertices and edges of the arrangement
+    for (uint32_t v = 0; v < kl.dcel.vertices.size(); v++) {
+        if (kl.dcel.is_inf(v)) continue;
+        point_2 c = kl.dcel.vertex_point(v);
+        for (point_2 p : {c, point_2(c.x + jitter(gen), c.y + jitter(gen))}) {
+            EXPECT_EQ(kl.fast_localization(p), dag_descent(kl, p));
+        }
+        for (double t : {0.5, 1e-9}) {
+            uint32_t e = kl.dcel.vertices[v].e;
+            if (kl.dcel.is_inf(kl.dcel.origin(kl.dcel.twin(e)))) continue;
+            point_2 q = kl.dcel.vertex_point(kl.dcel.origin(kl.dcel.twin(e)));
+            point_2 p(c.x + t * (q.x - c.x), c.y + t * (q.y - c.y));
+            EXPECT_EQ(kl.fast_localization(p), dag_descent(kl, p));
+        }
+    }
+}
+
+bool face_contains(const DCEL & dcel, uint32_t f, const point_2 & p)
+{
+    uint32_t e = dcel.faces[f].e;
+    do {
+        if (dcel.point2edge_orientation(e, p) == CG_RIGHT) {
+            return false;
+        }
+        e = dcel.next(e);
+    } while (e != dcel.faces[f].e);
+    return true;
+}
+
+TEST(dcel, locate_batch)
+{
+    mt19937 gen(8);
+    uniform_real_distribution<double> d(-150, 150);
+    kirkpatrick_localization kl(random_line(gen), random_line(gen));
+    for (int i = 0; i < 15; i++) {
+        kl.add_line(random_line(gen));
+    }
+
+    vector<vector<uint32_t>> deleted_vertices;
+    kl.build_triangulation(deleted_vertices);
+
+    // every seventh point lies outside of the bounding triangle of the hierarchy
+    vector<point_2> points;
+    for (int i = 0; i < 10003; i++) {
+        points.push_back(i % 7 ? point_2(d(gen), d(gen)) : point_2(1e6 + i, 1e6));
+    }
+
+    for (size_t threads : {1, 3}) {
+        vector<uint32_t> faces;
+        kl.locate_batch(points, faces, threads);
+        ASSERT_EQ(faces.size(), points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            EXPECT_EQ(faces[i], kl.locate(points[i]));
+            EXPECT_TRUE(face_contains(kl.dcel, faces[i], points[i]));
+        }
+    }
+}
+
+TEST(dcel, locate)
+{
+    mt19937 gen(4);
+    uniform_real_distribution<double> d(-150, 150);
+    DCEL dcel(random_line(gen), random_line(gen));
+    for (int i = 0; i < 40; i++) {
+        dcel.add_line(random_line(gen));
+    }
+
+    for (uint32_t f = 0; f < dcel.faces.size(); f++) {
+        uint32_t e = dcel.faces[f].e;
+        do {
+            if (!dcel.is_inf(dcel.origin(e))) {
+                EXPECT_TRUE(dcel.faces[f].bbox.contains(dcel.vertex_point(dcel.origin(e))));
+            }
+            e = dcel.next(e);
+        } while (e != dcel.faces[f].e);
+    }
+
+    uint32_t hint = no_index;
+    for (int i = 0; i < 500; i++) {
+        point_2 p(d(gen), d(gen));
+        uint32_t f = dcel.locate(p);
+        ASSERT_NE(f, no_index);
+        EXPECT_TRUE(face_contains(dcel, f, p));
+
+        hint = dcel.locate(p, hint);
+        EXPECT_TRUE(face_contains(dcel, hint, p));
+    }
+}
+
+TEST(dcel, locate_in_triangle)
+{
+    mt19937 gen(5);
+    uniform_real_distribution<double> d(-100, 100);
+    vector<line> lines;
+    for (int i = 0; i < 15; i++) {
+        lines.push_back(random_line(gen));
+    }
+    DCEL dcel(lines);
+    EXPECT_EQ(check_dcel(dcel), dcel.faces.size());
+
+    // hull edges bound the outer face, the bounding triangle lies left of and below all vertices
+    uint32_t outer = dcel.edges[0].face;
+    EXPECT_EQ(dcel.locate(point_2(1e9, 1e9)), outer);
+    EXPECT_EQ(dcel.locate(point_2(1e9, 1e9), 5), outer);
+
+    for (int i = 0; i < 300; i++) {
+        point_2 p(d(gen), d(gen));
+        uint32_t f = dcel.locate(p, i % dcel.faces.size());
+        if (f != outer) {
+            EXPECT_TRUE(face_contains(dcel, f, p));
+        }
+    }
+}
+
+// vertices of the face containing p
+vector<point_2> face_vertices(const DCEL & dcel, const point_2 & p)
+{
+    vector<point_2> res;
+    uint32_t f = dcel.locate(p);
+    uint32_t e = dcel.faces[f].e;
+    do {
+        if (!dcel.is_inf(dcel.origin(e))) {
+            res.push_back(dcel.vertex_point(dcel.origin(e)));
+        }
+        e = dcel.next(e);
+    } while (e != dcel.faces[f].e);
+    sort(res.begin(), res.end());
+    return res;
+}
+
+TEST(dcel, build)
+{
+    mt19937 gen(6);
+    uniform_real_distribution<double> d(-150, 150);
+    for (size_t n : {2, 3, 5, 40}) {
+        vector<line> lines;
+        for (size_t i = 0; i < n; i++) {
+            lines.push_back(random_line(gen));
+        }
+
+        DCEL built;
+        built.build(lines, 2);
+        EXPECT_EQ(built.vertices.size(), n * (n - 1) / 2 + 1);
+        EXPECT_EQ(built.faces.size(), 1 + n + n * (n - 1) / 2);
+        EXPECT_EQ(check_dcel(built), built.faces.size());
+
+        DCEL added(lines[0], lines[1]);
+        for (size_t i = 2; i < n; i++) {
+            added.add_line(lines[i]);
+        }
+        for (int i = 0; i < 100; i++) {
+            point_2 p(d(gen), d(gen));
+            EXPECT_EQ(face_vertices(built, p), face_vertices(added, p));
+        }
+
+        // lines can still be added one by one
+        line l = random_line(gen);
+        built.add_line(l);
+        added.add_line(l);
+        EXPECT_EQ(check_dcel(built), built.faces.size());
+        EXPECT_EQ(built.faces.size(), added.faces.size());
+    }
+}
+
+// locate against DCEL::locate on random points, and on vertices and edges where the face only has to touch the point
+void check_locator(point_locator & locator, const vector<line> & lines, mt19937 & gen)
+{
+    uniform_real_distribution<double> d(-150, 150);
+    locator.build(lines);
+    const DCEL & dcel = locator.arrangement();
+    uint32_t outer = dcel.edges[0].face;
+    EXPECT_EQ(locator.locate(point_2(1e9, 1e9)), outer);
+    EXPECT_EQ(locator.locate(point_2(-1e9, -1e9)), outer);
+
+    for (int i = 0; i < 2000; i++) {
+        point_2 p(d(gen), d(gen));
+        EXPECT_EQ(locator.locate(p), dcel.locate(p));
+    }
+
+    for (uint32_t v = 0; v < dcel.vertices.size(); v++) {
+        point_2 c = dcel.vertex_point(v);
+        point_2 q = dcel.vertex_point(dcel.origin(dcel.twin(dcel.vertices[v].e)));
+        for (point_2 p : {c, point_2((c.x + q.x) / 2, (c.y + q.y) / 2)}) {
+            uint32_t f = locator.locate(p);
+            if (f != outer) {
+                EXPECT_TRUE(face_contains(dcel, f, p));
+            }
+        }
+    }
+}
+
+TEST(dcel, point_locator)
+{
+    mt19937 gen(9);
+    vector<line> lines;
+    for (int i = 0; i < 12; i++) {
+        lines.push_back(random_line(gen));
+    }
+
+    kirkpatrick_locator kirkpatrick;
+    trapezoidal_map trapezoids;
+    check_locator(kirkpatrick, lines, gen);
+    check_locator(trapezoids, lines, gen);
+    EXPECT_EQ(kirkpatrick.arrangement().faces.size(), trapezoids.arrangement().faces.size());
+
+    // vertical edges and vertices sharing x
+    lines.push_back(line(1, 0, -3));
+    lines.push_back(line(1, 0, 7));
+    lines.push_back(line(0, -1, 5));
+    check_locator(trapezoids, lines, gen);
+
+    // the bounding triangle alone
+    for (size_t n : {0, 1}) {
+        vector<line> few(lines.begin(), lines.begin() + n);
+        check_locator(kirkpatrick, few, gen);
+        check_locator(trapezoids, few, gen);
+        EXPECT_EQ(kirkpatrick.arrangement().faces.size(), trapezoids.arrangement().faces.size());
+    }
+}
+
+TEST(dcel, append_line)
+{
+    mt19937 gen(10);
+    uniform_real_distribution<double> d(-150, 150);
+    kirkpatrick_localization kl(random_line(gen), random_line(gen));
+
+    size_t rebuilds = 0;
+    for (int i = 0; i < 18; i++) {
+        size_t built = kl.built_lines;
+        kl.append_line(random_line(gen));
+        rebuilds += (kl.built_lines != built);
+
+        for (int j = 0; j < 100; j++) {
+            point_2 p(d(gen), d(gen));
+            uint32_t f = kl.locate(p);
+            ASSERT_NE(f, no_index);
+            EXPECT_TRUE(face_contains(kl.dcel, f, p));
+        }
+    }
+    EXPECT_EQ(kl.dcel.all_lines.size(), 20);
+    EXPECT_LE(rebuilds, 8);
+}
+
+TEST(dcel, far_crossings)
+{
+    mt19937 gen(11);
+    vector<line> lines;
+    for (int i = 0; i < 10; i++) {
+        lines.push_back(random_line(gen));
+    }
+    // nearly parallel lines crossing about 1e9 away and an axis parallel pair
+    lines.push_back(line(1, -1, 0));
+    lines.push_back(line(1 + 1e-9, -1, 1));
+    lines.push_back(line(1, 0, 5));
+    lines.push_back(line(0, -1, 5));
+
+    DCEL dcel(lines);
+    size_t n = lines.size();
+    EXPECT_EQ(dcel.vertices.size(), 3 + 2 * n + n * (n - 1) / 2);
+    EXPECT_EQ(check_dcel(dcel), dcel.faces.size());
+    EXPECT_EQ(dcel.faces.size(), 2 + n + n * (n - 1) / 2);
+}
+
+// find_border_line as it was before border_candidates: shift by d until all crossings are on the sign side
+void border_line_by_all_crossings(line & l, double d, int sign, const vector<line> & lines)
+{
+    bool all_one_side = false;
+    while (!all_one_side) {
+        all_one_side = true;
+        for (size_t i = 0; i + 1 < lines.size() && all_one_side; i++) {
+            for (size_t j = i + 1; j < lines.size() && all_one_side; j++) {
+                if (orientation_2d(lines[i].a, lines[i].b, lines[j].a, lines[j].b) == ZERO_DEAD) continue;
+                all_one_side = line_point_sign(l, lines[i], lines[j]) * sign > 0;
+            }
+        }
+        if (!all_one_side) {
+            l.c += d;
+        }
+    }
+}
+
+// the three borders of DCEL(lines) by find_border_line and by the reference loop
+void check_border_lines(const vector<line> & lines)
+{
+    const DCEL dcel;
+    vector<line> fast(lines), slow(lines);
+    line borders[3] = {line(1, 0, 0), line(0, 1, 0), line(1, 1, 0)};
+    double d[3] = {200, 200, -200};
+    int sign[3] = {1, 1, -1};
+    for (int k = 0; k < 3; k++) {
+        line a = borders[k], b = borders[k];
+        dcel.find_border_line(a, d[k], sign[k], fast);
+        border_line_by_all_crossings(b, d[k], sign[k], slow);
+        EXPECT_EQ(a.c, b.c) << k;
+        fast.push_back(a);
+        slow.push_back(b);
+    }
+}
+
+TEST(dcel, find_border_line)
+{
+    mt19937 gen(13);
+    uniform_int_distribution<int> coef(-4, 4), pick(0, 3);
+    for (int t = 0; t < 300; t++) {
+        vector<line> lines;
+        for (int i = 0; i < 2 + t % 9; i++) {
+            int kind = pick(gen);
+            if (kind == 0 && !lines.empty()) {
+                // parallel to an earlier line
+                line l = lines[gen() % lines.size()];
+                lines.push_back(line(l.a, l.b, l.c + coef(gen)));
+            } else if (kind <= 1) {
+                // integer coefficients, axis parallel and crossings on the borders
+                double a = coef(gen), b = coef(gen);
+                lines.push_back(line(a == 0 && b == 0 ? 1 : a, b, 100 * coef(gen)));
+            } else {
+                lines.push_back(random_line(gen));
+            }
+        }
+        check_border_lines(lines);
+    }
+
+    // the arrangements the line_arrangement example starts from
+    check_border_lines(vector<line>{line(0, -1, 0), line(1, 0, 0)});
+    check_border_lines(vector<line>{line(1, -1, 0), line(-1, -1, 0)});
+    check_border_lines(vector<line>{line(0, -1, 0), line(1, 0, 0), line(1, -1, 0), line(-1, -1, 0)});
+}
+
+TEST(dcel, line_cross)
+{
+    mt19937 gen(12);
+    uniform_int_distribution<int> coef(-5, 5);
+    vector<line> lines;
+    for (int i = 0; i < 8; i++) {
+        lines.push_back(random_line(gen));
+    }
+    // lines through (1, 2) and (3, -1) give coinciding and collinear crossings
+    for (int i = 0; i < 8; i++) {
+        double a = coef(gen), b = coef(gen);
+        if (a == 0 && b == 0) continue;
+        lines.push_back(line(a, b, -a - 2 * b));
+        lines.push_back(line(a, b, -3 * a + b));
+    }
+
+    // DCEL keeps one per vertex in a flat array
+    EXPECT_TRUE(is_trivially_copyable<line>::value);
+    EXPECT_TRUE(is_trivially_copyable<line_cross>::value);
+
+    vector<line_cross> crossings;
+    vector<pair<size_t, size_t>> pairs;
+    for (size_t i = 0; i < lines.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (orientation_2d(lines[i].a, lines[i].b, lines[j].a, lines[j].b) == ZERO_DEAD) continue;
+            crossings.push_back(line_cross(lines[i], lines[j]));
+            pairs.push_back(make_pair(i, j));
+            point_2 p = intersection_point<double>(lines[i], lines[j]);
+            EXPECT_EQ(crossings.back().point(), p);
+        }
+    }
+
+    uniform_int_distribution<size_t> pick(0, crossings.size() - 1);
+    auto exact = [&](size_t k) { return intersection_point<mpq_class>(lines[pairs[k].first], lines[pairs[k].second]); };
+    auto sign = [](const mpq_class & v) { return sgn(v) > 0 ? 1 : (sgn(v) < 0 ? -1 : 0); };
+
+    line_predicate_counters() = line_predicate_stats{0, 0, 0};
+    int collinear = 0;
+    for (int k = 0; k < 5000; k++) {
+        size_t r = pick(gen), s = pick(gen), t = pick(gen);
+        point_2t<mpq_class> pr = exact(r), ps = exact(s), pt = exact(t);
+
+        orientation_t turn = orientation(crossings[r], crossings[s], crossings[t]);
+        EXPECT_EQ(turn, sign((ps.x - pr.x) * (pt.y - pr.y) - (ps.y - pr.y) * (pt.x - pr.x)));
+        collinear += (turn == CG_COLLINEAR);
+        EXPECT_EQ(x_dif(crossings[r], crossings[s]), sign(pr.x - ps.x));
+        EXPECT_EQ(y_dif(crossings[r], crossings[s]), sign(pr.y - ps.y));
+        const line & l = lines[pairs[t].first];
+        EXPECT_EQ(line_point_sign(l, crossings[r]), sign(l.a * pr.x + l.b * pr.y + l.c));
+    }
+    EXPECT_GT(collinear, 0);
+
+    line_predicate_stats stats = line_predicate_counters();
+    EXPECT_EQ(stats.calls, 4 * 5000);
+    EXPECT_GT(stats.exact, 0);
+    EXPECT_LE(stats.exact, stats.interval);
+}
@@ -0,0 +1,84 @@
+#include <vector>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "cg/triangulation/delaunay.h"
+
+using namespace std;
+using namespace cg;
+
+// every triangle is counterclockwise and no input point lies strictly inside its circumcircle
+void check_delaunay(vector<point_2> const & pts, triangle_mesh const & mesh)
+{
+   for (size_t i = 0; i != mesh.size(); ++i)
+   {
+      triangle_2 t = mesh.triangle(i);
+      EXPECT_EQ(orientation(t[0], t[1], t[2]), CG_LEFT);
+      for (point_2 const & p : pts)
+         EXPECT_NE(in_circle(t[0], t[1], t[2], p), CG_INSIDE);
+   }
+}
+
+TEST(delaunay, square)
+{
+   vector<point_2> pts = {point_2(0, 0), point_2(1, 0), point_2(1, 1), point_2(0, 1), point_2(0.5, 0.5)};
+   triangle_mesh mesh = delaunay(pts, true);
+   EXPECT_EQ(mesh.size(), 4);
+   check_delaunay(pts, mesh);
+}
+
+TEST(delaunay, degenerate)
+{
+   EXPECT_EQ(delaunay(vector<point_2>()).size(), 0);
+   EXPECT_EQ(delaunay(vector<point_2>(5, point_2(1, 1))).size(), 0);
+   EXPECT_EQ(delaunay({point_2(0, 0), point_2(1, 1), point_2(2, 2), point_2(3, 3)}).size(), 0);
+}
+
+TEST(delaunay, cocircular)
+{
+   vector<point_2> pts;
+   for (int i = 0; i != 24; ++i)
+      pts.push_back(point_2(cos(i * M_PI / 12), sin(i * M_PI / 12)));
+   triangle_mesh mesh = delaunay(pts);
+   EXPECT_EQ(mesh.size(), 22);
+   check_delaunay(pts, mesh);
+}
+
+TEST(delaunay, grid_with_duplicates)
+{
+   vector<point_2> pts;
+   for (int i = 0; i != 2; ++i)
+      for (int x = 0; x != 10; ++x)
+         for (int y = 0; y != 10; ++y)
+            pts.push_back(point_2(x, y));
+
+   triangle_mesh mesh = delaunay(pts, true);
+   // 2n - h - 2 for n = 100 points with h = 36 of them on the hull
+   EXPECT_EQ(mesh.size(), 162);
+   check_delaunay(pts, mesh);
+
+   for (size_t i = 0; i != mesh.neighbours.size(); ++i)
+   {
+      uint32_t j = mesh.neighbours[i];
+      if (j == no_neighbour)
+         continue;
+      EXPECT_EQ(count(mesh.neighbours.begin() + 3 * j, mesh.neighbours.begin() + 3 * j + 3, i / 3), 1);
+   }
+}
+
+TEST(delaunay, random)
+{
+   delaunay_builder builder;
+   triangle_mesh mesh;
+   for (uint32_t seed = 0; seed != 20; ++seed)
+   {
+      srand(seed);
+      vector<point_2> pts;
+      for (int i = 0; i != 300; ++i)
+         pts.push_back(point_2(rand() % 1000, rand() % 1000));
+
+      builder.seed = seed;
+      builder.build(pts, mesh);
+      check_delaunay(pts, mesh);
+   }
+}
@@ -4,6 +4,42 @@
 #include <cg/operations/has_intersection/triangle_segment.h>
 #include <cg/operations/has_intersection/rectangle_segment.h>
 
+#include <random>
+
+// the tests without bounding boxes and shared orientations
+static bool reference_intersection(cg::segment_2 const & a, cg::segment_2 const & b)
+{
+   if (a[0] == a[1])
+      return cg::contains(b, a[0]);
+
+   cg::orientation_t ab[2];
+   for (size_t l = 0; l != 2; ++l)
+      ab[l] = cg::orientation(a[0], a[1], b[l]);
+
+   if (ab[0] == ab[1] && ab[0] == cg::CG_COLLINEAR)
+      return cg::collinear_overlap(a, b);
+
+   if (ab[0] == ab[1])
+      return false;
+
+   for (size_t l = 0; l != 2; ++l)
+      ab[l] = cg::orientation(b[0], b[1], a[l]);
+
+   return ab[0] != ab[1];
+}
+
+static bool reference_intersection(cg::triangle_2 const & t, cg::segment_2 const & s)
+{
+   if (cg::contains(t, s[0]))
+      return true;
+
+   for (size_t l = 0; l != 3; ++l)
+      if (reference_intersection(t.side(l), s))
+         return true;
+
+   return false;
+}
+
 TEST(has_intersection, segment_segment)
 {
    using cg::point_2;
@@ -85,3 +121,23 @@ TEST(has_intersection, rectangle_segment)
    EXPECT_TRUE(cg::has_intersection(rectangle_2(a, b), segment_2(point_2(-1, -1), point_2(3, 3))));
    EXPECT_TRUE(cg::has_intersection(rectangle_2(a, b), segment_2(point_2(1, -1), point_2(1, 3))));
 }
+
+TEST(has_intersection, same_as_reference)
+{
+   using cg::point_2;
+   using cg::segment_2;
+   using cg::triangle_2;
+
+   // small integer coordinates, so that touching, collinear and degenerate cases are frequent
+   std::mt19937 gen(1);
+   std::uniform_int_distribution<int> d(0, 6);
+   auto pt = [&]() { return point_2(d(gen), d(gen)); };
+
+   for (size_t l = 0; l != 200000; ++l)
+   {
+      segment_2 a(pt(), pt()), b(pt(), pt());
+      triangle_2 t(pt(), pt(), pt());
+      EXPECT_EQ(reference_intersection(a, b), cg::has_intersection(a, b));
+      EXPECT_EQ(reference_intersection(t, b), cg::has_intersection(t, b));
+   }
+}
@@ -0,0 +1,52 @@
+#include <vector>
+#include <cmath>
+#include <random>
+#include <gtest/gtest.h>
+
+#include <cg/operations/in_circle.h>
+
+using namespace std;
+using namespace cg;
+
+TEST(in_circle, simple)
+{
+   point_2 a(0, 0), b(2, 0), c(0, 2);
+   EXPECT_EQ(in_circle(a, b, c, point_2(1, 1)), CG_INSIDE);
+   EXPECT_EQ(in_circle(a, b, c, point_2(2, 2)), CG_COCIRCULAR);
+   EXPECT_EQ(in_circle(a, b, c, point_2(3, 3)), CG_OUTSIDE);
+   EXPECT_EQ(in_circle(a, c, b, point_2(1, 1)), CG_OUTSIDE);
+}
+
+TEST(in_circle, near_cocircular)
+{
+   mt19937 gen(1);
+   uniform_real_distribution<double> angle(0, 2 * M_PI);
+
+   for (size_t k = 0; k != 1000; ++k)
+   {
+      point_2 p[4];
+      for (point_2 & q : p)
+      {
+         double t = angle(gen);
+         q = point_2(1e3 + 1e-3 * cos(t), -1e3 + 1e-3 * sin(t));
+      }
+      EXPECT_EQ(in_circle(p[0], p[1], p[2], p[3]), *in_circle_r()(p[0], p[1], p[2], p[3]));
+   }
+}
+
+TEST(in_circle, batch)
+{
+   mt19937 gen(2);
+   uniform_int_distribution<int> coord(-20, 20);
+
+   point_2 a(-5, 0), b(5, 0), c(0, 5);
+   vector<point_2> d;
+   for (size_t k = 0; k != 1000; ++k)
+      d.push_back(point_2(coord(gen) * 0.5, coord(gen) * 0.5));
+
+   vector<in_circle_t> res;
+   in_circle(a, b, c, d, res);
+   ASSERT_EQ(res.size(), d.size());
+   for (size_t k = 0; k != d.size(); ++k)
+      EXPECT_EQ(res[k], *in_circle_r()(a, b, c, d[k]));
+}
@@ -0,0 +1,125 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include <cg/operations/minkowski_sum.h>
+#include <cg/operations/convex_intersection.h>
+#include <cg/operations/convex.h>
+#include <cg/convex_hull/graham.h>
+
+using namespace std;
+using namespace cg;
+
+static contour_2 hull(vector<point_2> pts)
+{
+   pts.erase(graham_hull(pts.begin(), pts.end()), pts.end());
+   return contour_2(pts);
+}
+
+// the vertices of the contour without the collinear ones, starting from the smallest
+static vector<point_2> corners(contour_2 const & c)
+{
+   vector<point_2> pts(c.begin(), c.end());
+   pts.resize(detail::drop_collinear(pts.data(), pts.data() + pts.size()) - pts.data());
+   rotate(pts.begin(), min_element(pts.begin(), pts.end()), pts.end());
+   return pts;
+}
+
+// the sum fits in n + m points, has no repeated vertex and the corners of the hull of all the vertex sums
+static void check(contour_2 const & a, contour_2 const & b)
+{
+   size_t room = a.size() + b.size();
+   vector<point_2> buffer(room + 4, point_2(numeric_limits<double>::quiet_NaN(), 0));
+   size_t k = minkowski_sum(a, b, buffer.data()) - buffer.data();
+   ASSERT_LE(k, room);
+   for (size_t l = room; l != buffer.size(); ++l)
+      ASSERT_TRUE(std::isnan(buffer[l].x));
+
+   vector<point_2> res(buffer.begin(), buffer.begin() + k);
+   for (size_t l = 0; l != k; ++l)
+      EXPECT_TRUE(k == 1 || res[l] != res[(l + 1) % k]);
+
+   vector<point_2> sums;
+   for (point_2 const & p : a)
+      for (point_2 const & q : b)
+         sums.push_back(point_2(p.x + q.x, p.y + q.y));
+   contour_2 expected = hull(sums);
+
+   if (expected.size() >= 3)
+   {
+      EXPECT_TRUE(convex(contour_2(res)));
+      EXPECT_EQ(corners(expected), corners(contour_2(res)));
+   }
+   else
+   {
+      // a point or a segment, walked there and back
+      for (point_2 const & p : res)
+         EXPECT_TRUE(find(sums.begin(), sums.end(), p) != sums.end());
+      EXPECT_EQ(*min_element(sums.begin(), sums.end()), *min_element(res.begin(), res.end()));
+      EXPECT_EQ(*max_element(sums.begin(), sums.end()), *max_element(res.begin(), res.end()));
+   }
+}
+
+TEST(minkowski_sum, random)
+{
+   mt19937 gen(1);
+   uniform_real_distribution<double> d(-10, 10);
+   for (int k = 0; k != 300; ++k)
+   {
+      contour_2 c[2];
+      for (int s = 0; s != 2; ++s)
+      {
+         vector<point_2> pts;
+         for (int l = 0; l != 3 + k % 20; ++l)
+            pts.push_back(point_2(d(gen), d(gen)));
+         c[s] = hull(pts);
+      }
+      check(c[0], c[1]);
+   }
+}
+
+TEST(minkowski_sum, integer_grid)
+{
+   // parallel sides of both contours, degenerate hulls
+   mt19937 gen(2);
+   uniform_int_distribution<int> d(0, 4);
+   for (int k = 0; k != 2000; ++k)
+   {
+      contour_2 c[2];
+      for (int s = 0; s != 2; ++s)
+      {
+         vector<point_2> pts;
+         for (int l = 0; l != 1 + k % 6; ++l)
+            pts.push_back(point_2(d(gen), d(gen)));
+         c[s] = hull(pts);
+      }
+      check(c[0], c[1]);
+   }
+}
+
+TEST(minkowski_sum, special)
+{
+   contour_2 square(vector<point_2>{point_2(0, 0), point_2(2, 0), point_2(2, 2), point_2(0, 2)});
+   contour_2 triangle(vector<point_2>{point_2(0, 0), point_2(1, 0), point_2(0, 1)});
+   contour_2 point(vector<point_2>{point_2(3, 4)});
+   contour_2 segment(vector<point_2>{point_2(1, 1), point_2(0, 0)});
+   contour_2 dense(vector<point_2>{point_2(0, 0), point_2(1, 0), point_2(2, 0), point_2(2, 0), point_2(2, 2), point_2(0, 2), point_2(0, 1)});
+
+   contour_2 moved = minkowski_sum(square, point);
+   ASSERT_EQ(4u, moved.size());
+   EXPECT_EQ(corners(contour_2(vector<point_2>{point_2(3, 4), point_2(5, 4), point_2(5, 6), point_2(3, 6)})), corners(moved));
+
+   EXPECT_EQ(6u, minkowski_sum(square, segment).size());
+   EXPECT_EQ(7u, minkowski_sum(square, triangle).size());
+   EXPECT_EQ(5u, corners(minkowski_sum(square, triangle)).size());
+   EXPECT_EQ(0u, minkowski_sum(square, contour_2()).size());
+   EXPECT_EQ(1u, minkowski_sum(point, point).size());
+   EXPECT_EQ(4u, minkowski_sum(segment, segment).size());
+
+   for (contour_2 const & a : {square, triangle, point, segment, dense})
+      for (contour_2 const & b : {square, triangle, point, segment, dense})
+         check(a, b);
+}
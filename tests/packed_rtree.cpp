@@ -0,0 +1,134 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include <cg/trees/packed_rtree.h>
+
+using namespace std;
+using namespace cg;
+
+static vector<segment_2> random_segments(mt19937 & gen, size_t n, double length)
+{
+   uniform_real_distribution<double> coord(0, 100), delta(-length, length);
+   vector<segment_2> res;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen));
+      res.push_back(segment_2(a, point_2(a.x + delta(gen), a.y + delta(gen))));
+   }
+   return res;
+}
+
+static vector<triangle_2> random_triangles(mt19937 & gen, size_t n, double size)
+{
+   uniform_real_distribution<double> coord(0, 100), delta(-size, size);
+   vector<triangle_2> res;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen));
+      res.push_back(triangle_2(a, point_2(a.x + delta(gen), a.y + delta(gen)), point_2(a.x + delta(gen), a.y + delta(gen))));
+   }
+   return res;
+}
+
+static vector<rectangle_2> random_rectangles(mt19937 & gen, size_t n, double size)
+{
+   uniform_real_distribution<double> coord(0, 100), delta(0, size);
+   vector<rectangle_2> res;
+   for (size_t l = 0; l != n; ++l)
+   {
+      point_2 a(coord(gen), coord(gen));
+      res.push_back(rectangle_2(a, point_2(a.x + delta(gen), a.y + delta(gen))));
+   }
+   return res;
+}
+
+// single and batch queries report the primitives hit by the exact predicate, each once
+template <class Primitive, class Query>
+static void check(vector<Primitive> const & primitives, vector<Query> const & queries)
+{
+   packed_rtree<Primitive> tree(primitives, 2);
+   vector<uint32_t> first, hits;
+   tree.query(queries, first, hits, 2);
+   ASSERT_EQ(queries.size() + 1, first.size());
+
+   for (size_t k = 0; k != queries.size(); ++k)
+   {
+      vector<size_t> expected, found, batch(hits.begin() + first[k], hits.begin() + first[k + 1]);
+      for (size_t i = 0; i != primitives.size(); ++i)
+         if (detail::rtree_hit(queries[k], primitives[i]))
+            expected.push_back(i);
+
+      tree.query(queries[k], [&found](size_t i) { found.push_back(i); });
+      sort(found.begin(), found.end());
+      sort(batch.begin(), batch.end());
+      EXPECT_EQ(expected, found);
+      EXPECT_EQ(expected, batch);
+   }
+}
+
+TEST(packed_rtree, segments)
+{
+   mt19937 gen(1);
+   for (size_t n : {0, 1, 16, 17, 300, 5000})
+   {
+      vector<segment_2> segments = random_segments(gen, n, 5);
+      check(segments, random_rectangles(gen, 100, 10));
+      check(segments, random_segments(gen, 100, 10));
+      check(segments, random_triangles(gen, 100, 10));
+   }
+}
+
+TEST(packed_rtree, triangles)
+{
+   mt19937 gen(2);
+   for (size_t n : {1, 20, 3000})
+   {
+      vector<triangle_2> triangles = random_triangles(gen, n, 5);
+      check(triangles, random_rectangles(gen, 100, 10));
+      check(triangles, random_segments(gen, 100, 10));
+      check(triangles, random_triangles(gen, 100, 10));
+   }
+}
+
+TEST(packed_rtree, touching)
+{
+   // primitives on an integer grid, queries touching them at vertices and along sides
+   vector<segment_2> segments;
+   vector<triangle_2> triangles;
+   for (int x = 0; x != 20; ++x)
+      for (int y = 0; y != 20; ++y)
+      {
+         segments.push_back(segment_2(point_2(x, y), point_2(x + 1, y)));
+         triangles.push_back(triangle_2(point_2(x, y), point_2(x + 1, y), point_2(x, y + 1)));
+      }
+
+   vector<rectangle_2> rectangles;
+   vector<segment_2> queries;
+   for (int k = 0; k != 20; ++k)
+   {
+      rectangles.push_back(rectangle_2(point_2(k, k), point_2(k + 1, k)));
+      queries.push_back(segment_2(point_2(k, 0), point_2(0, k)));
+   }
+   check(segments, rectangles);
+   check(segments, queries);
+   check(triangles, rectangles);
+   check(triangles, queries);
+}
+
+TEST(has_intersection, triangle_triangle)
+{
+   triangle_2 t(point_2(0, 0), point_2(4, 0), point_2(0, 4));
+   EXPECT_TRUE(has_intersection(t, triangle_2(point_2(1, 1), point_2(2, 1), point_2(1, 2))));
+   EXPECT_TRUE(has_intersection(triangle_2(point_2(1, 1), point_2(2, 1), point_2(1, 2)), t));
+   EXPECT_TRUE(has_intersection(t, triangle_2(point_2(2, 2), point_2(3, 3), point_2(2, 5))));
+   EXPECT_FALSE(has_intersection(t, triangle_2(point_2(3, 3), point_2(4, 3), point_2(3, 4))));
+   EXPECT_TRUE(has_intersection(t, triangle_2(point_2(-1, 2), point_2(5, 2), point_2(2, 6))));
+
+   rectangle_2 r(point_2(1, 1), point_2(2, 2));
+   EXPECT_TRUE(has_intersection(r, t));
+   EXPECT_TRUE(has_intersection(rectangle_2(point_2(-1, -1), point_2(5, 5)), t));
+   EXPECT_TRUE(has_intersection(rectangle_2(point_2(2, 2), point_2(3, 3)), t));
+   EXPECT_FALSE(has_intersection(rectangle_2(point_2(2.5, 2.5), point_2(3, 3)), t));
+}
@@ -0,0 +1,212 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include <cg/intersections/polygon_boolean.h>
+#include <cg/operations/contains/contour_point.h>
+
+using namespace std;
+using namespace cg;
+
+typedef vector<contour_2> polygon;
+
+static contour_2 make_contour(vector<point_2> const & pts)
+{
+   return contour_2(pts);
+}
+
+static contour_2 box(double x0, double y0, double x1, double y1)
+{
+   return make_contour({point_2(x0, y0), point_2(x1, y0), point_2(x1, y1), point_2(x0, y1)});
+}
+
+// even-odd membership over the contours
+static bool inside(polygon const & p, point_2 const & q)
+{
+   bool res = false;
+   for (contour_2 const & c : p)
+      res ^= contains(c, q);
+   return res;
+}
+
+static bool expected(bool a, bool b, boolean_operation_t op)
+{
+   return op == CG_UNION ? a || b : op == CG_INTERSECTION ? a && b : a && !b;
+}
+
+static double area(polygon const & p)
+{
+   double res = 0;
+   for (contour_2 const & c : p)
+      for (size_t l = 0; l != c.size(); ++l)
+      {
+         point_2 const & s = c[l], & t = c[(l + 1) % c.size()];
+         res += s.x * t.y - s.y * t.x;
+      }
+   return res / 2;
+}
+
+// the result has ccw outer contours and cw holes, and holds the points where op holds for a and b
+static void check(polygon const & a, polygon const & b, boolean_operation_t op, mt19937 & gen, size_t samples = 2000)
+{
+   polygon res = boolean_operation(a, b, op);
+   for (contour_2 const & c : res)
+      EXPECT_GE(c.size(), 3u);
+
+   double x0 = 1e9, y0 = 1e9, x1 = -1e9, y1 = -1e9;
+   for (polygon const * p : {&a, &b})
+      for (contour_2 const & c : *p)
+         for (point_2 const & v : c)
+         {
+            x0 = min(x0, v.x), y0 = min(y0, v.y);
+            x1 = max(x1, v.x), y1 = max(y1, v.y);
+         }
+
+   uniform_real_distribution<double> dx(x0 - 1, x1 + 1), dy(y0 - 1, y1 + 1);
+   for (size_t l = 0; l != samples; ++l)
+   {
+      point_2 q(dx(gen), dy(gen));
+      ASSERT_EQ(expected(inside(a, q), inside(b, q), op), inside(res, q)) << "op " << op << " at " << q.x << " " << q.y;
+   }
+
+   // with ccw outer contours and cw holes the signed area is the area of the result
+   EXPECT_GE(area(res), -1e-9);
+}
+
+static void check_all(polygon const & a, polygon const & b, mt19937 & gen)
+{
+   for (boolean_operation_t op : {CG_UNION, CG_INTERSECTION, CG_DIFFERENCE})
+   {
+      check(a, b, op, gen);
+      check(b, a, op, gen);
+   }
+}
+
+TEST(polygon_boolean, boxes)
+{
+   polygon a(1, box(0, 0, 2, 2)), b(1, box(1, 1, 3, 3));
+   EXPECT_DOUBLE_EQ(7, area(polygon_union(a, b)));
+   EXPECT_DOUBLE_EQ(1, area(polygon_intersection(a, b)));
+   EXPECT_DOUBLE_EQ(3, area(polygon_difference(a, b)));
+   EXPECT_EQ(8u, polygon_union(a, b)[0].size());
+
+   mt19937 gen(1);
+   check_all(a, b, gen);
+}
+
+TEST(polygon_boolean, shared_sides)
+{
+   // boxes side by side, a box inside another with common sides, equal polygons, a common vertex
+   polygon a(1, box(0, 0, 1, 1));
+   polygon u = polygon_union(a, polygon(1, box(1, 0, 2, 1)));
+   ASSERT_EQ(1u, u.size());
+   EXPECT_EQ(4u, u[0].size());
+   EXPECT_DOUBLE_EQ(2, area(u));
+
+   EXPECT_TRUE(polygon_difference(a, a).empty());
+   EXPECT_DOUBLE_EQ(1, area(polygon_intersection(a, a)));
+   EXPECT_TRUE(polygon_intersection(a, polygon(1, box(1, 1, 2, 2))).empty());
+   EXPECT_EQ(2u, polygon_union(a, polygon(1, box(1, 1, 2, 2))).size());
+
+   mt19937 gen(2);
+   check_all(a, polygon(1, box(1, 0, 2, 1)), gen);
+   check_all(a, polygon(1, box(0, 0, 0.5, 1)), gen);
+   check_all(a, polygon(1, box(1, 1, 2, 2)), gen);
+   check_all(a, polygon(1, box(0.25, 0, 0.75, 2)), gen);
+}
+
+TEST(polygon_boolean, holes)
+{
+   // a frame (box with a hole of cw orientation) against a box over the hole
+   polygon frame = {box(0, 0, 4, 4), make_contour({point_2(1, 1), point_2(1, 3), point_2(3, 3), point_2(3, 1)})};
+
+   polygon b(1, box(2, 2, 5, 5));
+   polygon res = polygon_union(frame, b);
+   EXPECT_DOUBLE_EQ(12 + 9 - 4 + 1, area(res));
+
+   polygon hole = polygon_difference(polygon(1, box(-1, -1, 5, 5)), frame);
+   EXPECT_DOUBLE_EQ(36 - 12, area(hole));
+
+   mt19937 gen(3);
+   check_all(frame, b, gen);
+   check_all(frame, polygon(1, box(1, 1, 3, 3)), gen);
+   check_all(frame, polygon(1, box(0.5, 0.5, 3.5, 3.5)), gen);
+}
+
+TEST(polygon_boolean, random)
+{
+   // self-intersecting contours of random vertices, of real and of small integer coordinates
+   mt19937 gen(4);
+   uniform_real_distribution<double> real(0, 10);
+   uniform_int_distribution<int> grid(0, 6);
+   for (int k = 0; k != 40; ++k)
+   {
+      polygon p[2];
+      for (polygon & q : p)
+         for (int c = 0; c != 2; ++c)
+         {
+            vector<point_2> pts;
+            for (int l = 0; l != 7; ++l)
+               pts.push_back(k % 2 ? point_2(real(gen), real(gen)) : point_2(grid(gen), grid(gen)));
+            q.push_back(contour_2(pts));
+         }
+      check_all(p[0], p[1], gen);
+   }
+}
+
+TEST(polygon_boolean, convex)
+{
+   // the convex fast path against the general sweep
+   mt19937 gen(5);
+   uniform_real_distribution<double> angle(0, 2 * M_PI), radius(1, 2), shift(-2, 2);
+   for (int k = 0; k != 100; ++k)
+   {
+      polygon p[2];
+      for (polygon & q : p)
+      {
+         vector<double> t;
+         for (int l = 0; l != 8; ++l)
+            t.push_back(angle(gen));
+         sort(t.begin(), t.end());
+         double r = radius(gen), x = shift(gen), y = shift(gen);
+         vector<point_2> pts;
+         for (double s : t)
+            pts.push_back(point_2(x + r * cos(s), y + r * sin(s)));
+         q.push_back(contour_2(pts));
+      }
+
+      polygon fast = polygon_intersection(p[0], p[1]);
+      ASSERT_LE(fast.size(), 1u);
+      double reference = area(polygon_union(p[0], p[1])) - area(polygon_difference(p[0], p[1])) - area(polygon_difference(p[1], p[0]));
+      EXPECT_NEAR(reference, area(fast), 1e-9);
+      check(p[0], p[1], CG_INTERSECTION, gen, 500);
+   }
+}
+
+TEST(polygon_boolean, clip)
+{
+   mt19937 gen(6);
+   uniform_real_distribution<double> d(-10, 10);
+   vector<polygon> polygons;
+   for (int k = 0; k != 300; ++k)
+   {
+      point_2 o(d(gen), d(gen));
+      if (k % 2)
+         polygons.push_back(polygon(1, box(o.x, o.y, o.x + 3, o.y + 2)));
+      else
+         polygons.push_back(polygon(1, make_contour({o, point_2(o.x + 4, o.y), point_2(o.x + 1, o.y + 1), point_2(o.x, o.y + 4)})));
+   }
+
+   for (polygon const & window : {polygon(1, box(-5, -5, 5, 5)), polygon(1, make_contour({point_2(-6, -6), point_2(6, -6), point_2(0, 0), point_2(0, 6)}))})
+   {
+      vector<polygon> out;
+      clip(polygons, window, out, 4);
+      ASSERT_EQ(polygons.size(), out.size());
+      for (size_t k = 0; k != polygons.size(); ++k)
+      {
+         polygon ref = boolean_operation(polygons[k], window, CG_INTERSECTION);
+         EXPECT_NEAR(area(ref), area(out[k]), 1e-9);
+      }
+   }
+}
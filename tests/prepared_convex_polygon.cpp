@@ -0,0 +1,76 @@
+#include <vector>
+#include <random>
+#include <memory>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include <cg/operations/contains/prepared_convex_polygon.h>
+#include <cg/convex_hull/graham.h>
+
+using namespace std;
+using namespace cg;
+
+// single and batch queries answer as convex_contains, boundary included
+static void check(contour_2 const & c, vector<point_2> const & queries)
+{
+   prepared_convex_polygon prepared(c);
+   unique_ptr<bool[]> batch(new bool[queries.size()]);
+   prepared.contains(queries.data(), queries.size(), batch.get());
+   for (size_t l = 0; l != queries.size(); ++l)
+   {
+      bool expected = convex_contains(c, queries[l]);
+      EXPECT_EQ(expected, batch[l]) << queries[l].x << " " << queries[l].y;
+      EXPECT_EQ(expected, contains(prepared, queries[l])) << queries[l].x << " " << queries[l].y;
+   }
+}
+
+static contour_2 hull(vector<point_2> pts)
+{
+   pts.erase(graham_hull(pts.begin(), pts.end()), pts.end());
+   return contour_2(pts);
+}
+
+TEST(prepared_convex_polygon, circle)
+{
+   mt19937 gen(1);
+   uniform_real_distribution<double> d(-120, 120);
+   for (size_t n : {3, 4, 5, 7, 8, 9, 100, 1000})
+   {
+      vector<point_2> pts;
+      for (size_t l = 0; l != n; ++l)
+         pts.push_back(point_2(100 * cos(2 * M_PI * l / n), 100 * sin(2 * M_PI * l / n)));
+
+      vector<point_2> queries = pts;
+      for (size_t l = 0; l != 5000; ++l)
+         queries.push_back(point_2(d(gen), d(gen)));
+      check(contour_2(pts), queries);
+   }
+}
+
+TEST(prepared_convex_polygon, integer_grid)
+{
+   // hull vertices and the grid points on its edges go through the fallback
+   mt19937 gen(2);
+   uniform_int_distribution<int> d(0, 20);
+   for (int k = 0; k != 50; ++k)
+   {
+      vector<point_2> pts;
+      for (int l = 0; l != 40; ++l)
+         pts.push_back(point_2(d(gen), d(gen)));
+
+      vector<point_2> queries;
+      for (double x = -1; x <= 21; x += 0.5)
+         for (double y = -1; y <= 21; y += 0.5)
+            queries.push_back(point_2(x, y));
+      check(hull(pts), queries);
+   }
+}
+
+TEST(prepared_convex_polygon, degenerate)
+{
+   vector<point_2> queries = {point_2(0, 0), point_2(1, 1), point_2(2, 2), point_2(1, 0)};
+   check(contour_2(), queries);
+   check(contour_2(vector<point_2>(1, point_2(1, 1))), queries);
+   vector<point_2> segment = {point_2(0, 0), point_2(2, 2)};
+   check(contour_2(segment), queries);
+}
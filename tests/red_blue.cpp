@@ -0,0 +1,95 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include <cg/intersections/red_blue.h>
+
+using namespace std;
+using namespace cg;
+
+typedef pair<size_t, size_t> index_pair;
+
+// squares of side size at the points of an n by n grid of step 1, rotated by angle about the origin
+static vector<contour_2> squares(int n, double size, double angle, point_2 const & shift)
+{
+   double c = cos(angle), s = sin(angle);
+   vector<contour_2> res;
+   for (int i = 0; i != n; ++i)
+      for (int j = 0; j != n; ++j)
+      {
+         vector<point_2> pts;
+         double corner[4][2] = {{0, 0}, {size, 0}, {size, size}, {0, size}};
+         for (auto const & d : corner)
+         {
+            double x = i + d[0], y = j + d[1];
+            pts.push_back(point_2(c * x - s * y + shift.x, s * x + c * y + shift.y));
+         }
+         res.push_back(contour_2(pts));
+      }
+   return res;
+}
+
+// the sweep reports each red blue pair once, as the pairwise has_intersection
+static void check(vector<segment_2> const & red, vector<segment_2> const & blue)
+{
+   vector<index_pair> pairs;
+   red_blue_pairs(red, blue, back_inserter(pairs));
+   size_t reported = pairs.size();
+   sort(pairs.begin(), pairs.end());
+   EXPECT_EQ(reported, size_t(unique(pairs.begin(), pairs.end()) - pairs.begin()));
+
+   vector<index_pair> expected;
+   for (size_t r = 0; r != red.size(); ++r)
+      for (size_t b = 0; b != blue.size(); ++b)
+         if (has_intersection(red[r], blue[b]))
+            expected.push_back(index_pair(r, b));
+   EXPECT_EQ(expected, pairs);
+}
+
+TEST(red_blue, layer_segments)
+{
+   vector<contour_2> layer = squares(2, 1, 0, point_2(0, 0));
+   vector<segment_2> segments = layer_segments(layer);
+   ASSERT_EQ(16u, segments.size());
+   EXPECT_EQ(segment_2(point_2(0, 0), point_2(1, 0)), segments[0]);
+   EXPECT_EQ(segment_2(point_2(0, 1), point_2(0, 0)), segments[3]);
+   EXPECT_EQ(segment_2(point_2(0, 1), point_2(1, 1)), segments[4]);
+}
+
+TEST(red_blue, rotated_grids)
+{
+   for (double angle : {0.0, 0.3, 1.1})
+      check(layer_segments(squares(12, 0.7, 0, point_2(0, 0))),
+            layer_segments(squares(12, 0.6, angle, point_2(0.35, 0.25))));
+}
+
+TEST(red_blue, touching_layers)
+{
+   // squares sharing sides within a layer, layers sharing vertices, sides and collinear overlaps
+   check(layer_segments(squares(8, 1, 0, point_2(0, 0))),
+         layer_segments(squares(6, 1, 0, point_2(0.5, 0))));
+   check(layer_segments(squares(8, 1, 0, point_2(0, 0))),
+         layer_segments(squares(8, 0.5, M_PI / 4, point_2(1, 1))));
+}
+
+TEST(red_blue, random)
+{
+   // two random sets of disjoint short segments
+   mt19937 gen(1);
+   uniform_real_distribution<double> d(-30, 30), len(-3, 3);
+   for (int k = 0; k != 5; ++k)
+   {
+      vector<segment_2> layer[2];
+      for (vector<segment_2> & segments : layer)
+         while (segments.size() != 200)
+         {
+            point_2 a(d(gen), d(gen));
+            segment_2 s(a, point_2(a.x + len(gen), a.y + len(gen)));
+            if (none_of(segments.begin(), segments.end(), [&s](segment_2 const & t) { return has_intersection(s, t); }))
+               segments.push_back(s);
+         }
+      check(layer[0], layer[1]);
+   }
+}
@@ -1,8 +1,10 @@
 #include <vector>
 #include <iostream>
+#include <random>
 #include <gtest/gtest.h>
 
 #include "cg/triangulation/triangulation.h"
+#include "cg/triangulation/batch.h"
 #include "cg/operations/contains/triangle_point.h"
 #include "cg/operations/contains/segment_point.h"
 #include "cg/operations/contains/contour_point.h"
@@ -423,3 +425,105 @@ TEST(triangulation, from_kingdom_subdivision_45) {
    vector<triangle_2> v = triangulate(poly);
    check_triangulation(poly, v);
 }
+
+TEST(triangulation, indices_match_triangles) {
+   contour_2 outer({ point_2(-2, -2), point_2(2, -2), point_2(2, 2), point_2(-2, 2) });
+   contour_2 hole({ point_2(1, 1), point_2(1, -1), point_2(-1, -1), point_2(-1, 1) });
+   polygon poly = {outer, hole};
+   vector<point_2> pts;
+   for (auto cont : poly) for (auto p : cont) pts.push_back(p);
+
+   vector<uint32_t> idx;
+   triangulate(poly, idx);
+   vector<triangle_2> v = triangulate(poly);
+   ASSERT_EQ(v.size() * 3, idx.size());
+   for (size_t i = 0; i < v.size(); i++) {
+      EXPECT_EQ(v[i], triangle_2(pts[idx[3 * i]], pts[idx[3 * i + 1]], pts[idx[3 * i + 2]]));
+   }
+}
+
+TEST(triangulation, mesh_neighbours) {
+   contour_2 outer({ point_2(-2, -2), point_2(2, -2), point_2(2, 2), point_2(-2, 2) });
+   contour_2 hole({ point_2(1, 1), point_2(1, -1), point_2(-1, -1), point_2(-1, 1) });
+   polygon poly = {outer, hole};
+   triangle_mesh mesh;
+   triangulation_sweep sweep;
+   for (int run = 0; run < 2; run++) {
+      triangulate(poly, mesh, sweep, true);
+      vector<triangle_2> v;
+      for (size_t i = 0; i < mesh.size(); i++) v.push_back(mesh.triangle(i));
+      check_triangulation(poly, v);
+
+      // every side lies either on the border or is shared with its neighbour
+      size_t border = 0;
+      for (size_t i = 0; i < mesh.size(); i++) {
+         for (size_t k = 0; k < 3; k++) {
+            uint32_t j = mesh.neighbours[3 * i + k];
+            if (j == no_neighbour) {
+               border++;
+               continue;
+            }
+            segment_2 s = v[i].side(k);
+            bool shared = false;
+            for (size_t l = 0; l < 3; l++) {
+               segment_2 o = v[j].side(l);
+               shared |= (o[0] == s[0] && o[1] == s[1]) || (o[0] == s[1] && o[1] == s[0]);
+            }
+            EXPECT_TRUE(shared);
+         }
+      }
+      EXPECT_EQ(border, outer.size() + hole.size());
+   }
+}
+
+TEST(triangulation, batch) {
+   contour_2 outer({ point_2(-2, -2), point_2(2, -2), point_2(2, 2), point_2(-2, 2) });
+   contour_2 hole({ point_2(1, 1), point_2(1, -1), point_2(-1, -1), point_2(-1, 1) });
+   contour_2 star({ point_2(0, 0), point_2(-1, -1), point_2(1, 0), point_2(-1, 1) });
+   vector<polygon> polygons;
+   for (int i = 0; i < 1000; i++) {
+      if (i % 3 == 0) polygons.push_back({outer, hole});
+      else if (i % 3 == 1) polygons.push_back({star});
+      else polygons.push_back({});
+   }
+
+   triangle_mesh_batch batch;
+   triangulate(polygons, batch, 4);
+   ASSERT_EQ(batch.size(), polygons.size());
+   for (size_t i = 0; i < polygons.size(); i++) {
+      vector<triangle_2> v;
+      for (uint32_t t = batch.triangle_offsets[i]; t < batch.triangle_offsets[i + 1]; t++) {
+         for (int k = 0; k < 3; k++) {
+            uint32_t p = batch.mesh.triangles[3 * t + k];
+            EXPECT_TRUE(batch.vertex_offsets[i] <= p && p < batch.vertex_offsets[i + 1]);
+         }
+         v.push_back(batch.mesh.triangle(t));
+      }
+      EXPECT_EQ(v, triangulate(polygons[i]));
+   }
+}
+
+TEST(triangulation, small_and_convex) {
+   std::mt19937 gen(3);
+   std::uniform_real_distribution<double> jitter(0, 0.9), radius(1, 100);
+   for (int i = 0; i < 300; i++) {
+      size_t n = 3 + i % 40;
+
+      // star shaped around the origin, convex when all radii are equal
+      bool round = i % 2 == 0;
+      vector<point_2> pts;
+      for (size_t k = 0; k < n; k++) {
+         double t = 2 * M_PI * (k + jitter(gen)) / n, r = round ? 100 : radius(gen);
+         pts.push_back(point_2(r * cos(t), r * sin(t)));
+      }
+      polygon poly = {contour_2(pts)};
+      check_triangulation(poly, triangulate(poly));
+   }
+}
+
+TEST(triangulation, convex_with_straight_vertices) {
+   contour_2 outer({ point_2(0, 0), point_2(1, 0), point_2(2, 0), point_2(2, 1), point_2(2, 2), point_2(1, 2),
+                     point_2(0, 2), point_2(0, 1) });
+   polygon poly = {outer};
+   check_triangulation(poly, triangulate(poly));
+}